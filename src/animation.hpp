@@ -1,20 +1,17 @@
 #pragma once
 
 #include <string>
-#include <SFML/Graphics/Sprite.hpp>
-
-enum class OriginAnchor {
-    Center,
-    BottomLeft
-};
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Texture.hpp>
 
 /**
  * @brief Represents a texture-based animation made of one or more frames.
  * 
- * Manages the animation state (current frame) and provides access to a sprite for rendering.
+ * An Animation is an asset: it describes the frames (texture, frame count, speed, size) and is shared by every entity using it.
+ * The state of the animation of an entity (current frame) is stored in its CAnimation component.
  * 
  * An animation can be a single frame or multiple frames arranged in the texture.
- * The update() function changes the animation frame based on the defined speed.
+ * get_texture_rect(frame) returns the part of the texture to draw for a given frame, based on the defined speed.
  * 
  * @note Animation speed cannot not be zero.
  */
@@ -45,15 +42,20 @@ public:
     explicit Animation(std::string name, const sf::Texture &t, unsigned frame_count, unsigned speed);
 
     /**
-     * @brief Update the animation
+     * @brief Return true if the animation reaches the last frame
+     * 
+     * @param current_frame Number of updates of the animation
      */
-    void update() noexcept;
+    [[nodiscard]] 
+    bool has_ended(unsigned current_frame) const noexcept;
 
     /**
-     * @brief Return true if animation reaches the last frame
+     * @brief Return the part of the texture to draw
+     * 
+     * @param current_frame Number of updates of the animation
      */
     [[nodiscard]] 
-    bool has_ended() const noexcept;
+    sf::IntRect get_texture_rect(unsigned current_frame) const noexcept;
 
     /**
      * @brief Return animation's name
@@ -68,25 +70,16 @@ public:
     const sf::Vector2i &get_size() const noexcept;
 
     /**
-     * @brief Return the animation's sprite
+     * @brief Return the animation's texture
+     * 
+     * @note The animation must have been created with a texture
      */
     [[nodiscard]] 
-    const sf::Sprite &get_sprite() const;
-
-    /**
-     * @brief Return the animation's sprite
-     */
-    [[nodiscard]]
-    sf::Sprite &get_sprite();
-
-    void set_scale(const sf::Vector2f &s);
-
-    void set_origin(OriginAnchor a);
+    const sf::Texture &get_texture() const noexcept;
 
 private:
-    std::optional<sf::Sprite> m_sprite{};
+    const sf::Texture *m_texture{};
     unsigned m_frame_count{1};
-    unsigned m_current_frame{};
     unsigned m_speed{1};
     sf::Vector2i m_size{1, 1};
     std::string m_name{"default"};
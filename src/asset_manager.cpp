@@ -17,6 +17,35 @@ void AssetManager::add_texture(const std::string &name, const std::filesystem::p
     }
 }
 
+void AssetManager::add_textures(JobSystem &jobs, const std::vector<TextureConfig> &textures) noexcept
+{
+    /* Decoding is done on the CPU, it can run on any thread */
+    std::vector<sf::Image> images(textures.size());
+    std::vector<char> loaded(textures.size(), false);
+    jobs.parallel_for(textures.size(), 1, [&](size_t begin, size_t end)
+                      {
+                          for (size_t i = begin; i < end; ++i)
+                          {
+                              loaded[i] = images[i].loadFromFile(textures[i].path);
+                          } });
+
+    /* Upload needs the OpenGL context of this thread */
+    for (size_t i = 0; i < textures.size(); ++i)
+    {
+        sf::Texture texture;
+        if (!loaded[i] || !texture.loadFromImage(images[i]))
+        {
+            std::cerr << std::format("Could not load texture {}\n", textures[i].path);
+            continue;
+        }
+
+        if (!m_textures.try_emplace(textures[i].name, std::move(texture)).second)
+        {
+            std::cerr << std::format("Texture {} already stored\n", textures[i].name);
+        }
+    }
+}
+
 void AssetManager::add_animation(const std::string &name, const Animation &anim) noexcept
 {
     if (!m_animations.try_emplace(name, std::move(anim)).second)
@@ -55,6 +84,32 @@ void AssetManager::add_sound(const std::string &name, const std::filesystem::pat
     }
 }
 
+void AssetManager::add_sounds(JobSystem &jobs, const std::vector<SoundConfig> &sounds) noexcept
+{
+    std::vector<sf::SoundBuffer> buffers(sounds.size());
+    std::vector<char> loaded(sounds.size(), false);
+    jobs.parallel_for(sounds.size(), 1, [&](size_t begin, size_t end)
+                      {
+                          for (size_t i = begin; i < end; ++i)
+                          {
+                              loaded[i] = buffers[i].loadFromFile(sounds[i].path);
+                          } });
+
+    for (size_t i = 0; i < sounds.size(); ++i)
+    {
+        if (!loaded[i])
+        {
+            std::cerr << std::format("Could not load sound {}\n", sounds[i].path);
+            continue;
+        }
+
+        if (!m_sounds.try_emplace(sounds[i].name, std::move(buffers[i])).second)
+        {
+            std::cerr << std::format("Sound {} already stored\n", sounds[i].name);
+        }
+    }
+}
+
 void AssetManager::add_music(const std::string &name, const std::filesystem::path &path) noexcept
 {
     sf::Music music;
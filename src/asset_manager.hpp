@@ -3,10 +3,13 @@
 #include <unordered_map>
 #include <filesystem>
 #include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/Font.hpp>
 #include <SFML/Audio/SoundBuffer.hpp>
 #include <SFML/Audio/Music.hpp>
 #include "animation.hpp"
+#include "config_structs.hpp"
+#include "job_system.hpp"
 
 using TextureMap = std::unordered_map<std::string, sf::Texture>;
 using AnimationMap = std::unordered_map<std::string, Animation>;
@@ -49,6 +52,16 @@ public:
      */
     void add_texture(const std::string &name, const std::filesystem::path &path) noexcept;
 
+    /**
+     * @brief Store textures, their image files are decoded in parallel on the job system
+     *
+     * @param jobs Job system
+     * @param textures Name and path of each texture
+     *
+     * @note Must be called from the thread owning the window, textures are uploaded on the calling thread
+     */
+    void add_textures(JobSystem &jobs, const std::vector<TextureConfig> &textures) noexcept;
+
     /**
      * @brief Store an animation
      *
@@ -73,6 +86,14 @@ public:
      */
     void add_sound(const std::string &name, const std::filesystem::path &path) noexcept;
 
+    /**
+     * @brief Store sounds, their files are decoded in parallel on the job system
+     *
+     * @param jobs Job system
+     * @param sounds Name and path of each sound
+     */
+    void add_sounds(JobSystem &jobs, const std::vector<SoundConfig> &sounds) noexcept;
+
     /**
      * @brief Store a music
      *
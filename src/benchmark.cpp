@@ -0,0 +1,361 @@
+#include "benchmark.hpp"
+#include "job_system.hpp"
+#include "components.hpp"
+#include "entity_manager.hpp"
+#include "tile_grid.hpp"
+#include "static_bvh.hpp"
+#include "fixed_point.hpp"
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <numbers>
+#include <type_traits>
+
+////////////////////////////////////////// HELPER FUNCTIONS //////////////////////////////////////////
+
+/**
+ * @brief Convert a float to the number type of a workload
+ */
+template <typename T>
+[[nodiscard]]
+static constexpr T make_number(float value) noexcept
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        return value;
+    }
+    else
+    {
+        return Fixed::from_float(value);
+    }
+}
+
+/**
+ * @brief Return the bits of a number of a workload, to hash them
+ */
+template <typename T>
+[[nodiscard]]
+static uint64_t get_bits(T value) noexcept
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        return std::bit_cast<uint32_t>(value);
+    }
+    else
+    {
+        return static_cast<uint64_t>(value.raw());
+    }
+}
+
+/**
+ * @brief Fall, move and push out boxes in a number type, return the time and a FNV-1a hash of the final positions
+ */
+template <typename T>
+[[nodiscard]]
+static Benchmark::NumericResult run_physics_workload(const char *type, size_t body_count, size_t frames)
+{
+    const T gravity{make_number<T>(0.75f)};
+    const T max_speed{make_number<T>(20.0f)};
+    const T half_size{make_number<T>(8.0f)};
+    const T floor{make_number<T>(700.0f)};
+    const T zero{};
+
+    /* Rows of boxes close enough for each box to overlap the next one */
+    std::vector<T> pos_x(body_count);
+    std::vector<T> pos_y(body_count);
+    std::vector<T> vel_x(body_count);
+    std::vector<T> vel_y(body_count, zero);
+    for (size_t i = 0; i < body_count; ++i)
+    {
+        pos_x[i] = make_number<T>(static_cast<float>(i % 1000) * 12.5f);
+        pos_y[i] = make_number<T>(static_cast<float>((i / 1000) % 40) * 15.0f + static_cast<float>(i % 7) * 0.3f);
+        vel_x[i] = make_number<T>(static_cast<float>(i % 5) * 0.2f - 0.4f);
+    }
+
+    const auto start{std::chrono::steady_clock::now()};
+    for (size_t frame = 0; frame < frames; ++frame)
+    {
+        for (size_t i = 0; i < body_count; ++i)
+        {
+            vel_y[i] = std::min(vel_y[i] + gravity, max_speed);
+            pos_x[i] = pos_x[i] + vel_x[i];
+            pos_y[i] = pos_y[i] + vel_y[i];
+
+            if (pos_y[i] + half_size > floor)
+            {
+                pos_y[i] = floor - half_size;
+                vel_y[i] = zero;
+            }
+        }
+
+        for (size_t i = 0; i + 1 < body_count; ++i)
+        {
+            const T dx{pos_x[i] - pos_x[i + 1]};
+            const T dy{pos_y[i] - pos_y[i + 1]};
+            const T ox{half_size + half_size - (dx < zero ? zero - dx : dx)};
+            const T oy{half_size + half_size - (dy < zero ? zero - dy : dy)};
+            if (ox > zero && oy > zero)
+            {
+                pos_y[i] = pos_y[i] - oy;
+                vel_y[i] = zero;
+            }
+        }
+    }
+    const std::chrono::duration<float, std::milli> elapsed{std::chrono::steady_clock::now() - start};
+
+    uint64_t hash{14695981039346656037ull};
+    for (size_t i = 0; i < body_count; ++i)
+    {
+        for (const uint64_t bits : {get_bits(pos_x[i]), get_bits(pos_y[i])})
+        {
+            hash = (hash ^ bits) * 1099511628211ull;
+        }
+    }
+    return Benchmark::NumericResult{type, elapsed.count(), hash};
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+[[nodiscard]] std::vector<Benchmark::Result> Benchmark::job_system_scaling(size_t entity_count, size_t frames)
+{
+    constexpr size_t grain{1024};
+    const size_t max_threads{std::max(std::thread::hardware_concurrency(), 1u)};
+
+    std::vector<Result> results{};
+    for (size_t threads = 1; threads <= max_threads; ++threads)
+    {
+        /* Same initial state for each run */
+        std::vector<CTransform> transforms(entity_count);
+        std::vector<CGravity> gravities(entity_count);
+        for (size_t i = 0; i < entity_count; ++i)
+        {
+            transforms[i].pos = {static_cast<float>(i % 1000), static_cast<float>(i / 1000)};
+            transforms[i].velocity = {1.0f, 0.0f};
+            gravities[i].gravity = 0.5f + static_cast<float>(i % 7) * 0.1f;
+        }
+
+        /* The calling thread works too, so one thread less is needed */
+        JobSystem jobs(threads - 1);
+
+        const auto start{std::chrono::steady_clock::now()};
+        for (size_t frame = 0; frame < frames; ++frame)
+        {
+            jobs.parallel_for(entity_count, grain, [&transforms, &gravities](size_t begin, size_t end)
+                              {
+                                  for (size_t i = begin; i < end; ++i)
+                                  {
+                                      auto &transform{transforms[i]};
+                                      transform.velocity.y = std::min(transform.velocity.y + gravities[i].gravity, 20.0f);
+                                      transform.previous_pos = transform.pos;
+                                      transform.pos += transform.velocity;
+                                      transform.angle = std::atan2(transform.velocity.y, transform.velocity.x);
+                                  } });
+        }
+        const std::chrono::duration<float, std::milli> elapsed{std::chrono::steady_clock::now() - start};
+
+        results.push_back(Result{threads, elapsed.count()});
+    }
+    return results;
+}
+
+[[nodiscard]] std::vector<Benchmark::QueryResult> Benchmark::static_queries(size_t tile_count, size_t query_count)
+{
+    constexpr float cell{64.0f};
+    constexpr float ground_y{768.0f};
+    constexpr int32_t rows{96}; // Tall so the level stays narrow, the grid needs pixel coordinates precise to 0.01
+    constexpr float ray_length{512.0f};
+    const CCollisionFilter filter{};
+    std::mt19937 random{42};
+
+    /* Generate the level: ground, floating platforms, and a pole every few hundred columns */
+    EntityManager entities{};
+    entities.reserve(tile_count + tile_count / 100);
+    std::vector<TileGrid::Tile> tiles{};
+    tiles.reserve(tile_count + tile_count / 100);
+    const auto add_collider{[&](const sf::Vector2f &center, const sf::Vector2f &size)
+                            {
+                                auto entity{entities.add_entity(Tag::Tile)};
+                                entity.add<CTransform>(center);
+                                entity.add<CBoundingBox>(size);
+                                tiles.push_back(TileGrid::Tile{entity, TileType::Solid, Physics::get_bounds(entity), filter});
+                            }};
+
+    /* Each row has its own runs of platform tiles, started at random */
+    std::vector<int32_t> platform_lengths(rows, 0);
+    int32_t column{0};
+    while (tiles.size() < tile_count)
+    {
+        const float x{(static_cast<float>(column) + 0.5f) * cell};
+        add_collider(sf::Vector2f{x, ground_y - 0.5f * cell}, sf::Vector2f{cell, cell});
+
+        if (column % 300 == 150)
+        {
+            add_collider(sf::Vector2f{x, ground_y - cell - 160.0f}, sf::Vector2f{10.0f, 320.0f});
+        }
+
+        for (int32_t row = 3; row < rows; ++row)
+        {
+            auto &length{platform_lengths[static_cast<size_t>(row)]};
+            if (length == 0 && random() % 8 == 0)
+            {
+                length = 2 + static_cast<int32_t>(random() % 6);
+            }
+            if (length > 0)
+            {
+                add_collider(sf::Vector2f{x, ground_y - (static_cast<float>(row) + 0.5f) * cell}, sf::Vector2f{cell, cell});
+                length--;
+            }
+        }
+        column++;
+    }
+    entities.update();
+
+    /* Same queries for every method */
+    const float width{static_cast<float>(column) * cell};
+    std::uniform_real_distribution<float> random_x{0.0f, width};
+    std::uniform_real_distribution<float> random_y{ground_y - static_cast<float>(rows) * cell, ground_y};
+    std::uniform_real_distribution<float> random_angle{0.0f, 2.0f * std::numbers::pi_v<float>};
+
+    std::vector<Physics::Aabb> boxes(query_count);
+    std::vector<sf::Vector2f> origins(query_count);
+    std::vector<sf::Vector2f> directions(query_count);
+    for (size_t i = 0; i < query_count; ++i)
+    {
+        const sf::Vector2f center{random_x(random), random_y(random)};
+        boxes[i] = Physics::Aabb{center - sf::Vector2f{24.0f, 32.0f}, center + sf::Vector2f{24.0f, 32.0f}};
+        origins[i] = sf::Vector2f{random_x(random), random_y(random)};
+        const float angle{random_angle(random)};
+        directions[i] = sf::Vector2f{std::cos(angle), std::sin(angle)};
+    }
+
+    using Clock = std::chrono::steady_clock;
+    using Milliseconds = std::chrono::duration<float, std::milli>;
+    std::vector<QueryResult> results{};
+    EntityVec found{};
+
+    /* Brute force: every collider for every query */
+    {
+        QueryResult result{"Brute force"};
+        result.memory_bytes = tiles.size() * sizeof(TileGrid::Tile);
+
+        auto start{Clock::now()};
+        for (const auto &box : boxes)
+        {
+            for (const auto &tile : tiles)
+            {
+                result.overlap_hits += Physics::can_collide(filter, tile.filter) && Physics::overlaps(box, tile.bounds) && tile.entity.is_alive() ? 1 : 0;
+            }
+        }
+        result.overlap_milliseconds = Milliseconds{Clock::now() - start}.count();
+
+        start = Clock::now();
+        for (size_t i = 0; i < query_count; ++i)
+        {
+            bool hit{false};
+            float best{ray_length};
+            for (const auto &tile : tiles)
+            {
+                float distance{};
+                sf::Vector2f normal{};
+                if (Physics::can_collide(filter, tile.filter) && Physics::raycast_bounds(origins[i], directions[i], best, tile.bounds, distance, normal) &&
+                    tile.entity.is_alive())
+                {
+                    best = distance;
+                    hit = true;
+                }
+            }
+            result.raycast_hits += hit ? 1 : 0;
+        }
+        result.raycast_milliseconds = Milliseconds{Clock::now() - start}.count();
+        results.push_back(result);
+    }
+
+    /* Tile grid: cells under the query, the colliders that do not fit a cell are tested by brute force */
+    {
+        QueryResult result{"Tile grid"};
+        TileGrid grid{sf::Vector2f{cell, cell}};
+
+        auto start{Clock::now()};
+        const auto oversized{grid.build(ground_y, tiles)};
+        result.build_milliseconds = Milliseconds{Clock::now() - start}.count();
+        result.memory_bytes = static_cast<size_t>(grid.get_width()) * static_cast<size_t>(grid.get_height()) * sizeof(TileGrid::Cell) +
+                              oversized.size() * sizeof(TileGrid::Tile);
+
+        start = Clock::now();
+        for (const auto &box : boxes)
+        {
+            found.clear();
+            grid.overlap(box, filter, found);
+            for (const auto &tile : found)
+            {
+                result.overlap_hits += Physics::overlaps(box, Physics::get_bounds(tile)) ? 1 : 0;
+            }
+            for (const auto &tile : oversized)
+            {
+                result.overlap_hits += Physics::can_collide(filter, tile.filter) && Physics::overlaps(box, tile.bounds) && tile.entity.is_alive() ? 1 : 0;
+            }
+        }
+        result.overlap_milliseconds = Milliseconds{Clock::now() - start}.count();
+
+        start = Clock::now();
+        for (size_t i = 0; i < query_count; ++i)
+        {
+            Physics::RayHit ray_hit{};
+            bool hit{grid.raycast(origins[i], directions[i], ray_length, filter, ray_hit)};
+            const float best{hit ? ray_hit.distance : ray_length};
+            for (const auto &tile : oversized)
+            {
+                float distance{};
+                sf::Vector2f normal{};
+                hit |= Physics::can_collide(filter, tile.filter) && Physics::raycast_bounds(origins[i], directions[i], best, tile.bounds, distance, normal) &&
+                       tile.entity.is_alive();
+            }
+            result.raycast_hits += hit ? 1 : 0;
+        }
+        result.raycast_milliseconds = Milliseconds{Clock::now() - start}.count();
+        results.push_back(result);
+    }
+
+    /* Bounding volume hierarchy over every collider */
+    {
+        QueryResult result{"Static BVH"};
+        std::vector<StaticBvh::Collider> colliders{};
+        colliders.reserve(tiles.size());
+        for (const auto &tile : tiles)
+        {
+            colliders.push_back(StaticBvh::Collider{tile.entity, tile.bounds, tile.filter});
+        }
+
+        StaticBvh bvh{};
+        auto start{Clock::now()};
+        bvh.build(colliders);
+        result.build_milliseconds = Milliseconds{Clock::now() - start}.count();
+        result.memory_bytes = bvh.get_stats().memory_bytes;
+
+        start = Clock::now();
+        for (const auto &box : boxes)
+        {
+            found.clear();
+            bvh.query(box, filter, found);
+            result.overlap_hits += found.size();
+        }
+        result.overlap_milliseconds = Milliseconds{Clock::now() - start}.count();
+
+        start = Clock::now();
+        for (size_t i = 0; i < query_count; ++i)
+        {
+            Physics::RayHit ray_hit{};
+            result.raycast_hits += bvh.raycast(origins[i], directions[i], ray_length, filter, Entity{}, ray_hit) ? 1 : 0;
+        }
+        result.raycast_milliseconds = Milliseconds{Clock::now() - start}.count();
+        results.push_back(result);
+    }
+    return results;
+}
+
+[[nodiscard]] std::vector<Benchmark::NumericResult> Benchmark::fixed_point_throughput(size_t body_count, size_t frames)
+{
+    return std::vector<NumericResult>{run_physics_workload<float>("float", body_count, frames),
+                                      run_physics_workload<Fixed>("48.16 fixed point", body_count, frames)};
+}
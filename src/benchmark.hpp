@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Microbenchmarks, run from the ImGui window of the play scene
+ */
+namespace Benchmark
+{
+    /**
+     * @brief Time measured with a given number of threads
+     */
+    struct Result
+    {
+        size_t threads{};
+        float milliseconds{};
+    };
+
+    /**
+     * @brief Time spent by a static collider structure on the same queries
+     */
+    struct QueryResult
+    {
+        const char *method{};
+        float build_milliseconds{};
+        float overlap_milliseconds{};
+        float raycast_milliseconds{};
+        size_t memory_bytes{};
+        size_t overlap_hits{}; // Same for every method if they agree
+        size_t raycast_hits{};
+    };
+
+    /**
+     * @brief Time spent by the physics workload with a number type, and a hash of the final positions
+     */
+    struct NumericResult
+    {
+        const char *type{};
+        float milliseconds{};
+        uint64_t checksum{}; // The fixed point one is the same on every build
+    };
+
+    /**
+     * @brief Measure how the job system scales from 1 thread to every hardware thread.
+     *
+     * The workload is synthetic: transforms with gravity are integrated over several frames with parallel_for,
+     * like the movement system does. A new JobSystem is created for each thread count.
+     *
+     * @param entity_count Number of synthetic entities
+     * @param frames Number of simulated frames
+     *
+     * @return One result per thread count, the first one uses a single thread
+     */
+    [[nodiscard]]
+    std::vector<Result> job_system_scaling(size_t entity_count, size_t frames);
+
+    /**
+     * @brief Compare brute force, the TileGrid and the StaticBvh on overlap queries and raycasts.
+     *
+     * The level is generated: a ground, floating platforms on many rows with gaps between them,
+     * and a tall pole every few hundred columns, that does not fit a grid cell and is tested by brute force with the grid.
+     * Queries are player sized boxes and 512 px rays at random places, the same for every method.
+     *
+     * @param tile_count Number of tiles of the generated level
+     * @param query_count Number of overlap queries, and of raycasts
+     *
+     * @return Brute force, TileGrid and StaticBvh results, in this order
+     */
+    [[nodiscard]]
+    std::vector<QueryResult> static_queries(size_t tile_count, size_t query_count);
+
+    /**
+     * @brief Compare the throughput of float and 48.16 fixed point on the simulation math, whatever the build mode.
+     *
+     * The workload is synthetic: boxes fall with gravity, move, and are pushed out of their neighbour and of the floor,
+     * with the same operations as the movement and collision systems.
+     *
+     * @param body_count Number of boxes
+     * @param frames Number of simulated frames
+     *
+     * @return Float and fixed point results, in this order
+     */
+    [[nodiscard]]
+    std::vector<NumericResult> fixed_point_throughput(size_t body_count, size_t frames);
+}
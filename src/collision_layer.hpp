@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+/**
+ * @brief Collision layer of an entity, used to select which entities can collide.
+ *
+ * Each entity is on one layer and has a mask of the layers it collides with, see CCollisionFilter.
+ * Layers and masks are bitfields, so two entities are tested against each other only if
+ * each one is on a layer of the other's mask.
+ *
+ * @note To add a layer, insert it before Count and give it a name in collision_layer_names
+ */
+enum class CollisionLayer : uint8_t
+{
+    Player,
+    World,
+    Projectile,
+    Hazard,
+    Pickup,
+    Decoration,
+    Count
+};
+
+/**
+ * @brief Bitfield of collision layers, bit i is set for the i-th layer
+ */
+using CollisionMask = uint32_t;
+
+/**
+ * @brief Number of collision layers
+ */
+inline constexpr size_t collision_layer_count{static_cast<size_t>(CollisionLayer::Count)};
+
+static_assert(collision_layer_count <= 8 * sizeof(CollisionMask), "CollisionMask is too small for all layers");
+
+/**
+ * @brief Mask with every layer
+ */
+inline constexpr CollisionMask all_collision_layers{(CollisionMask{1} << collision_layer_count) - 1};
+
+/**
+ * @brief Name of each layer, as written in the config file
+ */
+inline constexpr std::array<const char *, collision_layer_count> collision_layer_names{
+    "player",
+    "world",
+    "projectile",
+    "hazard",
+    "pickup",
+    "decoration"};
+
+/**
+ * @brief Return the bit of the given layer in a CollisionMask
+ *
+ * @param layer Layer
+ */
+[[nodiscard]]
+constexpr CollisionMask collision_layer_bit(CollisionLayer layer) noexcept
+{
+    return CollisionMask{1} << static_cast<size_t>(layer);
+}
+
+/**
+ * @brief Return the layer with the given name, nothing if there is none
+ *
+ * @param name Name, as in collision_layer_names
+ */
+[[nodiscard]]
+constexpr std::optional<CollisionLayer> find_collision_layer(std::string_view name) noexcept
+{
+    for (size_t i = 0; i < collision_layer_count; ++i)
+    {
+        if (name == collision_layer_names[i])
+        {
+            return static_cast<CollisionLayer>(i);
+        }
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,53 @@
+#include "command_buffer.hpp"
+
+[[nodiscard]] PendingEntity CommandBuffer::spawn(Tag tag)
+{
+    m_spawns.push_back(tag);
+    return PendingEntity{static_cast<uint32_t>(m_spawns.size() - 1)};
+}
+
+void CommandBuffer::destroy(Entity entity)
+{
+    m_destroys.push_back(entity);
+}
+
+void CommandBuffer::flush(EntityManager &manager)
+{
+    /* Spawns, created in one batch */
+    manager.reserve(m_spawns.size());
+    m_spawned.clear();
+    m_spawned.reserve(m_spawns.size());
+    for (const auto tag : m_spawns)
+    {
+        m_spawned.push_back(manager.add_entity(tag));
+    }
+    m_spawns.clear();
+
+    /* Component additions, one pool at a time */
+    std::apply([this, &manager](auto &...commands)
+               { (flush_adds(manager, commands), ...); },
+               m_adds);
+
+    /* Component removals */
+    std::apply([this](auto &...commands)
+               { (flush_removes(commands), ...); },
+               m_removes);
+
+    /* Destructions, the handle may already be invalid if the entity was destroyed twice */
+    for (const auto &e : m_destroys)
+    {
+        e.destroy();
+    }
+    m_destroys.clear();
+}
+
+[[nodiscard]] bool CommandBuffer::empty() const noexcept
+{
+    const bool no_adds{std::apply([](const auto &...commands)
+                                  { return (commands.empty() && ...); },
+                                  m_adds)};
+    const bool no_removes{std::apply([](const auto &...commands)
+                                     { return (commands.empty() && ...); },
+                                     m_removes)};
+    return m_spawns.empty() && m_destroys.empty() && no_adds && no_removes;
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <vector>
+#include <tuple>
+#include <limits>
+#include "entity_manager.hpp"
+
+/**
+ * @brief Entity spawned in a CommandBuffer, it only exists once the buffer is flushed
+ */
+struct PendingEntity
+{
+    uint32_t index{};
+};
+
+/**
+ * @brief Records structural changes (spawn, destroy, add or remove components) to apply them later.
+ *
+ * Systems record their changes in their own buffer while they iterate over the entities,
+ * without touching the EntityManager storage. The buffers are flushed at a defined sync point,
+ * once no system is iterating anymore.
+ *
+ * Flush order is: spawns, component additions, component removals, then destructions.
+ * Spawns of a buffer are created in one batch, the manager and the pools reserve room for all of them at once.
+ *
+ * Usage:
+ *
+ * - spawn(tag): Record a new entity, components can be added to the returned PendingEntity
+ *
+ * - add<T>(entity, ...): Record a component addition, to an existing or a pending entity
+ *
+ * - remove<T>(entity): Record a component removal
+ *
+ * - destroy(entity): Record an entity destruction
+ *
+ * - flush(manager): Apply every recorded change and clear the buffer
+ *
+ * @note A buffer must only be used by one system at a time
+ */
+class CommandBuffer
+{
+public:
+    /**
+     * @brief Default constructor
+     */
+    explicit CommandBuffer() noexcept = default;
+
+    /**
+     * @brief Record the creation of an entity
+     *
+     * @param tag Entity's tag
+     */
+    [[nodiscard]]
+    PendingEntity spawn(Tag tag);
+
+    /**
+     * @brief Record the addition of a component to an existing entity
+     *
+     * @param entity Entity
+     * @param args Arguments forwarded to the component constructor
+     */
+    template <typename T, typename... Args>
+    void add(Entity entity, Args &&...args);
+
+    /**
+     * @brief Record the addition of a component to an entity spawned in this buffer
+     *
+     * @param entity Pending entity
+     * @param args Arguments forwarded to the component constructor
+     */
+    template <typename T, typename... Args>
+    void add(PendingEntity entity, Args &&...args);
+
+    /**
+     * @brief Record the removal of a component
+     *
+     * @param entity Entity
+     */
+    template <typename T>
+    void remove(Entity entity);
+
+    /**
+     * @brief Record the destruction of an entity
+     *
+     * @param entity Entity
+     */
+    void destroy(Entity entity);
+
+    /**
+     * @brief Apply every recorded change to the manager, then clear the buffer
+     *
+     * @param manager Manager storing the entities
+     */
+    void flush(EntityManager &manager);
+
+    /**
+     * @brief Check if nothing is recorded
+     */
+    [[nodiscard]]
+    bool empty() const noexcept;
+
+private:
+    static constexpr uint32_t no_spawn{std::numeric_limits<uint32_t>::max()};
+
+    /**
+     * @brief Recorded component, given to an existing entity or to a spawned one
+     */
+    template <typename T>
+    struct AddCommand
+    {
+        Entity entity{};
+        uint32_t spawn{no_spawn};
+        T component{};
+    };
+
+    /**
+     * @brief One list of commands per component type, following the order of ComponentPools
+     */
+    template <typename Pools, template <typename> typename Command>
+    struct CommandLists;
+
+    template <typename... Ts, template <typename> typename Command>
+    struct CommandLists<std::tuple<ComponentPool<Ts>...>, Command>
+    {
+        using type = std::tuple<std::vector<Command<Ts>>...>;
+    };
+
+    /**
+     * @brief Recorded removal of a component
+     */
+    template <typename T>
+    struct RemoveCommand
+    {
+        Entity entity{};
+    };
+
+    /**
+     * @brief Apply the recorded additions of one component type
+     *
+     * @param manager Manager storing the entities
+     * @param commands Recorded additions
+     */
+    template <typename T>
+    void flush_adds(EntityManager &manager, std::vector<AddCommand<T>> &commands);
+
+    /**
+     * @brief Apply the recorded removals of one component type
+     *
+     * @param commands Recorded removals
+     */
+    template <typename T>
+    void flush_removes(std::vector<RemoveCommand<T>> &commands) noexcept;
+
+private:
+    std::vector<Tag> m_spawns{};
+    EntityVec m_spawned{};
+    typename CommandLists<ComponentPools, AddCommand>::type m_adds{};
+    typename CommandLists<ComponentPools, RemoveCommand>::type m_removes{};
+    EntityVec m_destroys{};
+};
+
+/* TEMPLATE FUNCTIONS HERE */
+
+template <typename T, typename... Args>
+void CommandBuffer::add(Entity entity, Args &&...args)
+{
+    std::get<component_index<T>()>(m_adds).push_back(AddCommand<T>{entity, no_spawn, T(std::forward<Args>(args)...)});
+}
+
+template <typename T, typename... Args>
+void CommandBuffer::add(PendingEntity entity, Args &&...args)
+{
+    std::get<component_index<T>()>(m_adds).push_back(AddCommand<T>{Entity{}, entity.index, T(std::forward<Args>(args)...)});
+}
+
+template <typename T>
+void CommandBuffer::remove(Entity entity)
+{
+    std::get<component_index<T>()>(m_removes).push_back(RemoveCommand<T>{entity});
+}
+
+template <typename T>
+void CommandBuffer::flush_adds(EntityManager &manager, std::vector<AddCommand<T>> &commands)
+{
+    auto &pool{manager.get_pool<T>()};
+    pool.reserve(pool.size() + commands.size());
+
+    for (auto &command : commands)
+    {
+        const Entity &target{command.spawn == no_spawn ? command.entity : m_spawned[command.spawn]};
+        target.add<T>(std::move(command.component));
+    }
+    commands.clear();
+}
+
+template <typename T>
+void CommandBuffer::flush_removes(std::vector<RemoveCommand<T>> &commands) noexcept
+{
+    for (const auto &command : commands)
+    {
+        command.entity.template remove<T>();
+    }
+    commands.clear();
+}
@@ -0,0 +1,345 @@
+#pragma once
+
+#include <vector>
+#include <tuple>
+#include <limits>
+#include <cstdint>
+#include <type_traits>
+#include <memory>
+#include <utility>
+#include "components.hpp"
+
+/**
+ * @brief Dense storage for every component of a single type.
+ *
+ * The pool is a sparse set: a sparse array maps an entity id to an index in the dense arrays,
+ * and the dense arrays hold the components and the id of their owner side by side.
+ *
+ * Systems that only need one component type can walk components() linearly,
+ * without touching any other component data.
+ *
+ * Usage:
+ *
+ * - emplace(id, ...) to add (or replace) the component of an entity
+ *
+ * - contains(id) to check if an entity has the component
+ *
+ * - get(id) to access the component of an entity
+ *
+ * - remove(id) to remove the component of an entity
+ *
+ * - components() / entities() to iterate over the dense arrays
+ *
+ * - mark_changed(id, tick) / ticks() to record and read when each component was last changed
+ *
+ * @note Removal moves the last component into the hole, so it is O(1) but the dense order is not the order of addition
+ * @note Change ticks are not updated automatically when a component is modified through a reference, systems mark what they change
+ */
+template <typename T>
+class ComponentPool
+{
+public:
+    /**
+     * @brief Default constructor
+     */
+    explicit ComponentPool() noexcept = default;
+
+    /**
+     * @brief Add a component to the given entity, replace it if the entity already has one
+     *
+     * @param id Entity's id
+     * @param args Arguments forwarded to the component constructor
+     */
+    template <typename... Args>
+    T &emplace(size_t id, Args &&...args);
+
+    /**
+     * @brief Remove the component of the given entity, do nothing if it has none.
+     *
+     * The last component takes its place in the dense arrays.
+     *
+     * @param id Entity's id
+     */
+    void remove(size_t id) noexcept;
+
+    /**
+     * @brief Check if the given entity has a component in this pool
+     *
+     * @param id Entity's id
+     */
+    [[nodiscard]]
+    bool contains(size_t id) const noexcept;
+
+    /**
+     * @brief Return the component of the given entity
+     *
+     * @param id Entity's id
+     *
+     * @note The entity must have the component
+     */
+    [[nodiscard]]
+    T &get(size_t id) noexcept;
+
+    /**
+     * @brief Return the component of the given entity
+     *
+     * @param id Entity's id
+     *
+     * @note The entity must have the component
+     */
+    [[nodiscard]]
+    const T &get(size_t id) const noexcept;
+
+    /**
+     * @brief Record that the component of the given entity changed during the given tick
+     *
+     * @param id Entity's id
+     * @param tick Current tick of the EntityManager
+     *
+     * @note The entity must have the component
+     */
+    void mark_changed(size_t id, uint32_t tick) noexcept;
+
+    /**
+     * @brief Return the tick of the last change of the component of the given entity
+     *
+     * @param id Entity's id
+     *
+     * @note The entity must have the component
+     */
+    [[nodiscard]]
+    uint32_t get_tick(size_t id) const noexcept;
+
+    /**
+     * @brief Reserve room for the given number of components in the dense arrays
+     *
+     * @param capacity Total number of components
+     */
+    void reserve(size_t capacity);
+
+    /**
+     * @brief Return the number of components stored
+     */
+    [[nodiscard]]
+    size_t size() const noexcept;
+
+    /**
+     * @brief Return the dense array of components
+     */
+    [[nodiscard]]
+    std::vector<T> &components() noexcept;
+
+    /**
+     * @brief Return the dense array of components
+     */
+    [[nodiscard]]
+    const std::vector<T> &components() const noexcept;
+
+    /**
+     * @brief Return the id of the owner of each component, in the same order as components()
+     */
+    [[nodiscard]]
+    const std::vector<size_t> &entities() const noexcept;
+
+    /**
+     * @brief Return the tick of the last change of each component, in the same order as components()
+     */
+    [[nodiscard]]
+    std::vector<uint32_t> &ticks() noexcept;
+
+    /**
+     * @brief Return the tick of the last change of each component, in the same order as components()
+     */
+    [[nodiscard]]
+    const std::vector<uint32_t> &ticks() const noexcept;
+
+private:
+    static constexpr size_t npos{std::numeric_limits<size_t>::max()};
+
+    std::vector<size_t> m_sparse{};
+    std::vector<size_t> m_entities{};
+    std::vector<T> m_components{};
+    std::vector<uint32_t> m_ticks{};
+};
+
+/**
+ * @brief One pool per component type, owned by the EntityManager
+ */
+using ComponentPools = std::tuple<ComponentPool<CTransform>,
+                                  ComponentPool<CLifeSpan>,
+                                  ComponentPool<CInput>,
+                                  ComponentPool<CBoundingBox>,
+                                  ComponentPool<CAnimation>,
+                                  ComponentPool<CGravity>,
+                                  ComponentPool<CState>,
+                                  ComponentPool<CJump>,
+                                  ComponentPool<CSound>,
+                                  ComponentPool<CBoundingConvex>,
+                                  ComponentPool<CCollisionFilter>>;
+
+/**
+ * @brief Bitmask of the components of an entity, bit i is set if the entity has the component stored in the i-th pool
+ */
+using ComponentMask = uint32_t;
+
+static_assert(std::tuple_size_v<ComponentPools> <= 8 * sizeof(ComponentMask), "ComponentMask is too small for all components");
+
+/**
+ * @brief Return the bit of the component type T in a ComponentMask
+ */
+template <typename T>
+[[nodiscard]]
+constexpr ComponentMask component_bit() noexcept;
+
+/**
+ * @brief Return the mask made of all the given component types
+ */
+template <typename... Ts>
+[[nodiscard]]
+constexpr ComponentMask component_mask() noexcept
+{
+    return (component_bit<Ts>() | ... | ComponentMask{0});
+}
+
+/* TEMPLATE FUNCTIONS HERE */
+
+template <typename T, size_t I = 0>
+[[nodiscard]]
+constexpr size_t component_index() noexcept
+{
+    static_assert(I < std::tuple_size_v<ComponentPools>, "Component type has no pool");
+
+    if constexpr (std::is_same_v<std::tuple_element_t<I, ComponentPools>, ComponentPool<T>>)
+    {
+        return I;
+    }
+    else
+    {
+        return component_index<T, I + 1>();
+    }
+}
+
+template <typename T>
+constexpr ComponentMask component_bit() noexcept
+{
+    return ComponentMask{1} << component_index<T>();
+}
+
+template <typename T>
+template <typename... Args>
+T &ComponentPool<T>::emplace(size_t id, Args &&...args)
+{
+    /* Components are trivially copyable, the old one can be overwritten in place */
+    if (contains(id))
+    {
+        return *std::construct_at(&m_components[m_sparse[id]], std::forward<Args>(args)...);
+    }
+
+    if (id >= m_sparse.size())
+    {
+        m_sparse.resize(id + 1, npos);
+    }
+
+    m_sparse[id] = m_components.size();
+    m_entities.push_back(id);
+    m_ticks.push_back(0);
+    return m_components.emplace_back(std::forward<Args>(args)...);
+}
+
+template <typename T>
+void ComponentPool<T>::remove(size_t id) noexcept
+{
+    if (!contains(id))
+    {
+        return;
+    }
+
+    /* Move the last component into the hole, only the moved entity has to be re-indexed */
+    const size_t index{m_sparse[id]};
+    const size_t last{m_components.size() - 1};
+    if (index != last)
+    {
+        m_components[index] = std::move(m_components[last]);
+        m_entities[index] = m_entities[last];
+        m_ticks[index] = m_ticks[last];
+        m_sparse[m_entities[index]] = index;
+    }
+    m_components.pop_back();
+    m_entities.pop_back();
+    m_ticks.pop_back();
+    m_sparse[id] = npos;
+}
+
+template <typename T>
+bool ComponentPool<T>::contains(size_t id) const noexcept
+{
+    return id < m_sparse.size() && m_sparse[id] != npos;
+}
+
+template <typename T>
+T &ComponentPool<T>::get(size_t id) noexcept
+{
+    return m_components[m_sparse[id]];
+}
+
+template <typename T>
+const T &ComponentPool<T>::get(size_t id) const noexcept
+{
+    return m_components[m_sparse[id]];
+}
+
+template <typename T>
+void ComponentPool<T>::mark_changed(size_t id, uint32_t tick) noexcept
+{
+    m_ticks[m_sparse[id]] = tick;
+}
+
+template <typename T>
+uint32_t ComponentPool<T>::get_tick(size_t id) const noexcept
+{
+    return m_ticks[m_sparse[id]];
+}
+
+template <typename T>
+void ComponentPool<T>::reserve(size_t capacity)
+{
+    m_entities.reserve(capacity);
+    m_components.reserve(capacity);
+    m_ticks.reserve(capacity);
+}
+
+template <typename T>
+size_t ComponentPool<T>::size() const noexcept
+{
+    return m_components.size();
+}
+
+template <typename T>
+std::vector<T> &ComponentPool<T>::components() noexcept
+{
+    return m_components;
+}
+
+template <typename T>
+const std::vector<T> &ComponentPool<T>::components() const noexcept
+{
+    return m_components;
+}
+
+template <typename T>
+const std::vector<size_t> &ComponentPool<T>::entities() const noexcept
+{
+    return m_entities;
+}
+
+template <typename T>
+std::vector<uint32_t> &ComponentPool<T>::ticks() noexcept
+{
+    return m_ticks;
+}
+
+template <typename T>
+const std::vector<uint32_t> &ComponentPool<T>::ticks() const noexcept
+{
+    return m_ticks;
+}
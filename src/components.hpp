@@ -1,23 +1,25 @@
 #pragma once
 
+#include <array>
+#include <span>
+#include <algorithm>
+#include <type_traits>
 #include <SFML/System/Vector2.hpp>
-#include <SFML/Audio/Sound.hpp>
 #include "animation.hpp"
+#include "sound_bank.hpp"
+#include "collision_layer.hpp"
 
-/**
- * @brief Abstract base component
- */
-struct Component
-{
-    bool exists{false};
-    virtual ~Component() noexcept = 0;
-};
-inline Component::~Component() noexcept = default;
+/*
+Components are plain data: no base class, no virtual function, no owning member.
+They can be copied with memcpy, stored in raw arrays and copied in bulk.
+Whether an entity has a component is stored in its component mask, not in the component.
+Data shared between entities (animations, sound buffers) is referenced, it is owned by the AssetManager.
+*/
 
 /**
  * @brief Transform component for position, velocity, etc.
  */
-struct CTransform : public Component
+struct CTransform
 {
     sf::Vector2f pos{};
     sf::Vector2f previous_pos{};
@@ -35,7 +37,7 @@ struct CTransform : public Component
      *
      * @param p Position
      */
-    explicit CTransform(const sf::Vector2f &p) noexcept : pos(p)
+    explicit CTransform(const sf::Vector2f &p) noexcept : pos(p), previous_pos(p)
     {
     }
 
@@ -56,7 +58,7 @@ struct CTransform : public Component
 /**
  * @brief Lifespan component to know when to destroy an entity
  */
-struct CLifeSpan : public Component
+struct CLifeSpan
 {
     unsigned lifespan{};
     unsigned frame_created{};
@@ -81,7 +83,7 @@ struct CLifeSpan : public Component
 /**
  * @brief Input component to handle user inputs
  */
-struct CInput : public Component
+struct CInput
 {
     bool up{false};
     bool down{false};
@@ -99,12 +101,16 @@ struct CInput : public Component
 
 /**
  * @brief Bounding box component to know if entities collide
+ *
+ * Swept boxes collide along their whole motion of the frame, from previous_pos to pos,
+ * so fast entities cannot go through thin colliders between two frames.
  */
-struct CBoundingBox : public Component
+struct CBoundingBox
 {
     sf::Vector2f size{};
     sf::Vector2f half_size{};
     sf::Vector2f offset{};
+    bool swept{false};
 
     /**
      * @brief Default constructor
@@ -116,8 +122,10 @@ struct CBoundingBox : public Component
      *
      * @param s Box size
      * @param o Box offset, relative to the sprite origin
+     * @param sw True if the box collides along its motion, see Physics::get_first_sweep_hit
      */
-    explicit CBoundingBox(const sf::Vector2f &s, const sf::Vector2f &o = {0.0f, 0.0f}) noexcept : size(s), half_size(0.5f * s), offset(o)
+    explicit CBoundingBox(const sf::Vector2f &s, const sf::Vector2f &o = {0.0f, 0.0f}, bool sw = false) noexcept
+        : size(s), half_size(0.5f * s), offset(o), swept(sw)
     {
     }
 };
@@ -125,9 +133,10 @@ struct CBoundingBox : public Component
 /**
  * @brief Animation component to make an animated entity
  */
-struct CAnimation : public Component
+struct CAnimation
 {
-    Animation animation{};
+    const Animation *animation{}; // Owned by the AssetManager
+    unsigned current_frame{};
     bool repeat{false};
 
     /**
@@ -138,10 +147,10 @@ struct CAnimation : public Component
     /**
      * @brief Create an Animation Component
      *
-     * @param a Animation
+     * @param a Animation, must outlive the component
      * @param r True if the animation is repeated
      */
-    explicit CAnimation(Animation a, bool r) noexcept : animation(std::move(a)), repeat(r)
+    explicit CAnimation(const Animation &a, bool r) noexcept : animation(&a), repeat(r)
     {
     }
 };
@@ -149,7 +158,7 @@ struct CAnimation : public Component
 /**
  * @brief Gravity component to apply a downward force on an entity
  */
-struct CGravity : public Component
+struct CGravity
 {
     float gravity{};
 
@@ -168,13 +177,26 @@ struct CGravity : public Component
     }
 };
 
+/**
+ * @brief States of the player, each one has its own animation
+ */
+enum class PlayerState : uint8_t
+{
+    Idle,
+    IdleShoot,
+    Run,
+    RunShoot,
+    Air,
+    AirShoot
+};
+
 /**
  * @brief State component to know the current state of an entity
  */
-struct CState : public Component
+struct CState
 {
-    std::string state{"idle"};
-    std::string previous_state{"idle"};
+    PlayerState state{PlayerState::Idle};
+    PlayerState previous_state{PlayerState::Idle};
     bool change_animation{false};
 
     /**
@@ -187,7 +209,7 @@ struct CState : public Component
      *
      * @brief s State
      */
-    explicit CState(std::string s) noexcept : state(std::move(s))
+    explicit CState(PlayerState s) noexcept : state(s), previous_state(s)
     {
     }
 };
@@ -195,9 +217,10 @@ struct CState : public Component
 /**
  * @brief Jump component to handle variable jump height 
  */
-struct CJump : public Component
+struct CJump
 {
     bool jumping{false};
+    bool grounded{false};   // A contact of the last collision pass pushes the entity up
     unsigned start_frame{}; // Updated when input.up == true
     unsigned max_duration{};
     float initial_strength{};
@@ -223,9 +246,11 @@ struct CJump : public Component
 /**
  * @brief Sound component to play a sound  
  */
-struct CSound : public Component
+struct CSound
 {
-    std::optional<sf::Sound> sound{};
+    const sf::SoundBuffer *buffer{}; // Owned by the AssetManager
+    SoundHandle voice{};             // Voice playing the sound, valid once played
+    float volume{100.0f};
     bool loop{false};
     bool played{false};
 
@@ -237,27 +262,35 @@ struct CSound : public Component
     /**
      * @brief Create a Sound Component
      *
-     * @param buffer Sound Buffer
+     * @param b Sound Buffer, must outlive the component
      * @param loop True if sound loops
+     * @param v Volume
      */
-    explicit CSound(const sf::SoundBuffer &buffer, bool loop, float volume = 100.0f) noexcept : loop(loop)
+    explicit CSound(const sf::SoundBuffer &b, bool loop, float v = 100.0f) noexcept : buffer(&b), volume(v), loop(loop)
     {
-        sound.emplace(buffer);
-        sound->setLooping(loop);
-        sound->setVolume(volume);
     }
 };
 
 /**
  * @brief Convex Hitbox component
  * 
- * @note Points must be given in local space
+ * The unit normals of the edges are computed once, shapes do not rotate so they are the same in world space.
+ * Colliders that never move can also cache their points in world space, see Physics::cache_world_points.
+ *
+ * @note Points must be given in local space, in order around the shape
+ * @note Only the first max_points points are kept
  */
-struct CBoundingConvex : public Component
+struct CBoundingConvex
 {
-    std::vector<sf::Vector2f> points{};
+    static constexpr size_t max_points{8};
+
+    std::array<sf::Vector2f, max_points> points{};
+    std::array<sf::Vector2f, max_points> normals{};      // Normal of the edge from points[i] to points[i + 1], zero for empty edges
+    std::array<sf::Vector2f, max_points> world_points{}; // Points scaled and moved to world_pos, valid if world_cached
+    sf::Vector2f world_pos{};
     sf::Vector2f scale{1.0f, 1.0f};
     size_t count{};
+    bool world_cached{false};
 
     /**
      * @brief Default constructor
@@ -270,7 +303,57 @@ struct CBoundingConvex : public Component
      * @param p Points representing the convex shape, in local space
      * @param s Scaling factor, equivalent of "size" for CBoundingBox
      */
-    explicit CBoundingConvex(const std::vector<sf::Vector2f> &p, const sf::Vector2f &s) noexcept : points(p), scale(s), count(p.size())
+    explicit CBoundingConvex(std::span<const sf::Vector2f> p, const sf::Vector2f &s) noexcept : scale(s), count(std::min(p.size(), max_points))
+    {
+        std::copy_n(p.begin(), count, points.begin());
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const sf::Vector2f edge{(points[(i + 1) % count] - points[i]).componentWiseMul(scale)};
+            const sf::Vector2f normal{-edge.y, edge.x};
+            if (normal.lengthSquared() > 0.0f)
+            {
+                normals[i] = normal.normalized();
+            }
+        }
+    }
+};
+
+/**
+ * @brief Collision filter component, the layer of the entity and the layers it collides with
+ *
+ * Two entities collide only if each one is on a layer of the other's mask.
+ * Entities without this component collide with every layer.
+ */
+struct CCollisionFilter
+{
+    CollisionMask layer{all_collision_layers};
+    CollisionMask mask{all_collision_layers};
+
+    /**
+     * @brief Default constructor
+     */
+    explicit CCollisionFilter() noexcept = default;
+
+    /**
+     * @brief Create a CollisionFilter component
+     *
+     * @param l Bit of the layer of the entity
+     * @param m Layers the entity collides with
+     */
+    explicit CCollisionFilter(CollisionMask l, CollisionMask m) noexcept : layer(l), mask(m)
     {
     }
 };
+
+static_assert(std::is_trivially_copyable_v<CTransform>);
+static_assert(std::is_trivially_copyable_v<CLifeSpan>);
+static_assert(std::is_trivially_copyable_v<CInput>);
+static_assert(std::is_trivially_copyable_v<CBoundingBox>);
+static_assert(std::is_trivially_copyable_v<CAnimation>);
+static_assert(std::is_trivially_copyable_v<CGravity>);
+static_assert(std::is_trivially_copyable_v<CState>);
+static_assert(std::is_trivially_copyable_v<CJump>);
+static_assert(std::is_trivially_copyable_v<CSound>);
+static_assert(std::is_trivially_copyable_v<CBoundingConvex>);
+static_assert(std::is_trivially_copyable_v<CCollisionFilter>);
@@ -48,6 +48,13 @@ static BulletConfig parse_bullet(const toml::value &data)
     return parse_section<BulletConfig>(data, "bullet");
 }
 
+[[nodiscard]]
+static std::vector<CollisionConfig> parse_collision(const toml::value &data)
+{
+    auto collisions{parse_section_with_subsections<CollisionConfig>(data, "collision")};
+    return collisions;
+}
+
 [[nodiscard]]
 static std::vector<LevelConfig> parse_level(const toml::value &data)
 {
@@ -99,6 +106,7 @@ ConfigParser::ConfigParser(const std::filesystem::path &config_filepath) : m_fil
     m_window_config = parse_window(data);
     // m_player_config = parse_player(data);
     m_bullet_config = parse_bullet(data);
+    m_collision_configs = parse_collision(data);
     m_level_configs = parse_level(data);
     m_font_configs = parse_font(data);
     m_texture_configs = parse_texture(data);
@@ -122,6 +130,11 @@ const BulletConfig &ConfigParser::get_bullet_config() const noexcept
     return m_bullet_config;
 }
 
+const std::vector<CollisionConfig> &ConfigParser::get_collision_config() const noexcept
+{
+    return m_collision_configs;
+}
+
 const std::vector<LevelConfig> &ConfigParser::get_level_config() const noexcept
 {
     return m_level_configs;
@@ -6,7 +6,7 @@
  * @brief Loads and stores game config data from a TOML file.
  * 
  * The ConfigParser reads a TOML config file and extracts structured data
- * such as window settings, bullet parameters, level infos and assets references.
+ * such as window settings, bullet parameters, collision layers, level infos and assets references.
  * 
  * Once loaded, the config values can be accessed through dedicated getters,
  * allowing other systems to retrieve settings without having to parse the file again.
@@ -48,6 +48,12 @@ public:
     [[nodiscard]]
     const BulletConfig &get_bullet_config() const noexcept;
 
+    /**
+     * @brief Return collision filters info (tag, layer, mask)
+     */
+    [[nodiscard]]
+    const std::vector<CollisionConfig> &get_collision_config() const noexcept;
+
     /**
      * @brief Return levels info (level name, data file)
      */
@@ -89,6 +95,7 @@ private:
     WindowConfig m_window_config{};
     // PlayerConfig m_player_config{};
     BulletConfig m_bullet_config{};
+    std::vector<CollisionConfig> m_collision_configs{};
     std::vector<LevelConfig> m_level_configs{};
     std::vector<FontConfig> m_font_configs{};
     std::vector<TextureConfig> m_texture_configs{};
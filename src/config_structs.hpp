@@ -2,6 +2,7 @@
 
 #include <string>
 #include <array>
+#include <vector>
 #include <toml.hpp>
 
 struct WindowConfig
@@ -10,9 +11,10 @@ struct WindowConfig
     unsigned height{};
     std::string title{};
     unsigned framerate{};
+    unsigned tick_rate{};
     std::array<uint8_t, 4> color{0, 0, 0, 255};
 };
-TOML11_DEFINE_CONVERSION_NON_INTRUSIVE(WindowConfig, width, height, title, framerate, color)
+TOML11_DEFINE_CONVERSION_NON_INTRUSIVE(WindowConfig, width, height, title, framerate, tick_rate, color)
 
 // struct PlayerConfig
 // {
@@ -29,8 +31,17 @@ struct BulletConfig
     float speed{};
     float radius{};
     unsigned lifespan{};
+    bool swept{};
 };
-TOML11_DEFINE_CONVERSION_NON_INTRUSIVE(BulletConfig, speed, radius, lifespan)
+TOML11_DEFINE_CONVERSION_NON_INTRUSIVE(BulletConfig, speed, radius, lifespan, swept)
+
+struct CollisionConfig
+{
+    std::string tag{};
+    std::string layer{};
+    std::vector<std::string> mask{};
+};
+TOML11_DEFINE_CONVERSION_NON_INTRUSIVE(CollisionConfig, tag, layer, mask)
 
 struct LevelConfig
 {
@@ -0,0 +1,177 @@
+#include "contact_queue.hpp"
+#include <algorithm>
+#include "components.hpp"
+
+ContactQueue::ContactQueue(size_t capacity) : m_events(capacity)
+{
+    m_previous.reserve(capacity);
+    m_current.reserve(capacity);
+}
+
+void ContactQueue::begin_frame() noexcept
+{
+    m_previous.swap(m_current);
+    m_current.clear();
+    m_retained = 0;
+}
+
+void ContactQueue::report(const Entity &a, const Entity &b, const sf::Vector2f &normal, float penetration, const sf::Vector2f &velocity)
+{
+    const uint64_t key{make_key(a, b)};
+    const auto *previous{find_previous(key, a, b)};
+    const auto phase{previous ? ContactPhase::Stay : ContactPhase::Begin};
+    const ContactEvent event{a, b, phase, normal, penetration, velocity, previous ? previous->event.age + 1 : 0};
+
+    m_current.push_back(Contact{key, event});
+    push(event);
+}
+
+void ContactQueue::retain(const Entity &entity)
+{
+    for (const auto &contact : m_previous)
+    {
+        if (contact.event.a != entity && contact.event.b != entity)
+        {
+            continue;
+        }
+
+        /* A contact with an entity destroyed, or left without bounding box while it animates away, since the last pass is gone,
+           end_frame() emits its End */
+        const Entity &other{contact.event.a == entity ? contact.event.b : contact.event.a};
+        if (other.is_alive() && other.has<CBoundingBox>())
+        {
+            m_retained++;
+            m_current.push_back(contact);
+            m_current.back().event.phase = ContactPhase::Stay;
+            m_current.back().event.age++;
+        }
+    }
+}
+
+void ContactQueue::end_frame()
+{
+    /* A pair reported twice in the same pass is kept once, with its first contact */
+    std::stable_sort(m_current.begin(), m_current.end(), [](const Contact &lhs, const Contact &rhs)
+                     { return lhs.key < rhs.key; });
+    m_current.erase(std::unique(m_current.begin(), m_current.end(), [](const Contact &lhs, const Contact &rhs)
+                                { return lhs.key == rhs.key; }),
+                    m_current.end());
+
+    /* Both lists are sorted, the contacts only in the previous one are gone */
+    auto current{m_current.begin()};
+    for (const auto &contact : m_previous)
+    {
+        while (current != m_current.end() && current->key < contact.key)
+        {
+            ++current;
+        }
+
+        if (current == m_current.end() || current->key != contact.key)
+        {
+            ContactEvent event{contact.event};
+            event.phase = ContactPhase::End;
+            push(event);
+        }
+    }
+}
+
+[[nodiscard]] std::optional<ContactEvent> ContactQueue::get_previous(const Entity &a, const Entity &b) const noexcept
+{
+    const auto *contact{find_previous(make_key(a, b), a, b)};
+    if (!contact)
+    {
+        return std::nullopt;
+    }
+    return seen_from(contact->event, a);
+}
+
+[[nodiscard]] bool ContactQueue::pop(ContactEvent &event) noexcept
+{
+    if (m_size == 0)
+    {
+        return false;
+    }
+
+    event = m_events[m_head];
+    m_head = (m_head + 1) % m_events.size();
+    m_size--;
+    return true;
+}
+
+void ContactQueue::clear() noexcept
+{
+    m_head = 0;
+    m_size = 0;
+    m_dropped = 0;
+    m_retained = 0;
+    m_previous.clear();
+    m_current.clear();
+}
+
+[[nodiscard]] size_t ContactQueue::size() const noexcept
+{
+    return m_size;
+}
+
+[[nodiscard]] size_t ContactQueue::get_contact_count() const noexcept
+{
+    return m_current.size();
+}
+
+[[nodiscard]] size_t ContactQueue::get_retained() const noexcept
+{
+    return m_retained;
+}
+
+[[nodiscard]] size_t ContactQueue::get_dropped() const noexcept
+{
+    return m_dropped;
+}
+
+[[nodiscard]] uint64_t ContactQueue::make_key(const Entity &a, const Entity &b) noexcept
+{
+    const uint64_t low{std::min(a.id(), b.id())};
+    const uint64_t high{std::max(a.id(), b.id())};
+    return (low << 32) | high;
+}
+
+[[nodiscard]] ContactEvent ContactQueue::seen_from(const ContactEvent &event, const Entity &entity) noexcept
+{
+    if (event.a == entity)
+    {
+        return event;
+    }
+
+    ContactEvent swapped{event};
+    swapped.a = event.b;
+    swapped.b = event.a;
+    swapped.normal = -event.normal;
+    swapped.velocity = -event.velocity;
+    return swapped;
+}
+
+[[nodiscard]] const ContactQueue::Contact *ContactQueue::find_previous(uint64_t key, const Entity &a, const Entity &b) const noexcept
+{
+    const auto it{std::lower_bound(m_previous.begin(), m_previous.end(), key, [](const Contact &contact, uint64_t value)
+                                   { return contact.key < value; })};
+    if (it == m_previous.end() || it->key != key)
+    {
+        return nullptr;
+    }
+
+    /* Ids are reused, the previous contact must be between the same entities */
+    const bool same{(it->event.a == a && it->event.b == b) || (it->event.a == b && it->event.b == a)};
+    return same ? &*it : nullptr;
+}
+
+void ContactQueue::push(const ContactEvent &event) noexcept
+{
+    if (m_size == m_events.size())
+    {
+        m_dropped++;
+        return;
+    }
+
+    m_events[(m_head + m_size) % m_events.size()] = event;
+    m_size++;
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <SFML/System/Vector2.hpp>
+#include "entity_manager.hpp"
+
+/**
+ * @brief Phase of a contact between two entities
+ */
+enum class ContactPhase : uint8_t
+{
+    Begin, // First frame of the contact
+    Stay,  // The entities were already in contact in the previous frame
+    End    // The entities were in contact in the previous frame, they are not anymore
+};
+
+/**
+ * @brief Contact found by the collision system
+ */
+struct ContactEvent
+{
+    Entity a{};            // Entity moved by the resolution, or the moving one
+    Entity b{};            // Other entity
+    ContactPhase phase{ContactPhase::Begin};
+    sf::Vector2f normal{}; // Unit vector from b to a, along which a was pushed out, (0, 0) if unknown
+    float penetration{};   // Depth of a into b along the normal, or the largest overlap if the normal is unknown
+    sf::Vector2f velocity{}; // Velocity of a relative to b when the contact was found, before the resolution changed it
+    uint32_t age{};        // Number of passes the contact lasted before this one, 0 on Begin
+};
+
+/**
+ * @brief Queue of the contact events of a frame, in a ring buffer allocated once, and cache of the contacts between frames.
+ *
+ * The collision system reports the contacts it finds and resolves, then gameplay handlers
+ * pop the events once the resolution is over. The queue remembers the contacts of the previous frame,
+ * to tell a new contact (Begin) from a steady one (Stay), and to emit End for the contacts that are gone.
+ *
+ * The remembered contacts keep their normal, penetration and age: the resolution reuses the axis of a steady contact
+ * instead of guessing it again, and the state of an entity (on the ground or not) is read from its contacts.
+ *
+ * Pairs are unordered: (a, b) and (b, a) are the same contact.
+ *
+ * Usage:
+ *
+ * - begin_frame(): Start a collision pass, the contacts of the last pass become the previous ones
+ *
+ * - report(a, b, normal, penetration, velocity): Add a contact of this pass, emits Begin or Stay
+ *
+ * - retain(entity): Keep the previous contacts of an entity that was not tested this pass, without event, unless the other entity died or lost its bounding box
+ *
+ * - end_frame(): Emit End for the previous contacts that were not reported nor retained
+ *
+ * - pop(event): Read the events in the order they were emitted
+ *
+ * - get_previous(a, b): Contact of a pair in the previous pass, during a pass
+ *
+ * - for_each_contact(entity, function): Contacts of an entity in the last pass, once it is over
+ *
+ * @note When the ring buffer is full, new events are dropped and counted, see get_dropped()
+ */
+class ContactQueue
+{
+public:
+    /**
+     * @brief Create a queue
+     *
+     * @param capacity Maximum number of events waiting to be popped
+     */
+    explicit ContactQueue(size_t capacity);
+
+    /**
+     * @brief Start a collision pass
+     */
+    void begin_frame() noexcept;
+
+    /**
+     * @brief Add a contact found by this pass
+     *
+     * @param a Entity moved by the resolution, or the moving one
+     * @param b Other entity
+     * @param normal Unit vector from b to a, (0, 0) if unknown
+     * @param penetration Depth of a into b
+     * @param velocity Velocity of a relative to b, before the resolution
+     */
+    void report(const Entity &a, const Entity &b, const sf::Vector2f &normal, float penetration, const sf::Vector2f &velocity);
+
+    /**
+     * @brief Keep the previous contacts of an entity, for entities skipped by this pass
+     *
+     * @param entity Entity
+     */
+    void retain(const Entity &entity);
+
+    /**
+     * @brief End the collision pass, emit End for the contacts that are gone
+     */
+    void end_frame();
+
+    /**
+     * @brief Return the contact of a pair in the previous pass, seen from a: the normal goes from b to a
+     *
+     * @param a First entity
+     * @param b Second entity
+     */
+    [[nodiscard]]
+    std::optional<ContactEvent> get_previous(const Entity &a, const Entity &b) const noexcept;
+
+    /**
+     * @brief Call function(contact) for each contact of the entity in the last pass, seen from the entity
+     *
+     * @param entity Entity
+     * @param function Called with a ContactEvent whose a is the entity
+     */
+    template <typename F>
+    void for_each_contact(const Entity &entity, F &&function) const;
+
+    /**
+     * @brief Remove the oldest event
+     *
+     * @param event Event popped
+     *
+     * @return False if the queue is empty
+     */
+    [[nodiscard]]
+    bool pop(ContactEvent &event) noexcept;
+
+    /**
+     * @brief Remove every event and forget the contacts
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Return the number of events waiting
+     */
+    [[nodiscard]]
+    size_t size() const noexcept;
+
+    /**
+     * @brief Return the number of contacts of the last pass
+     */
+    [[nodiscard]]
+    size_t get_contact_count() const noexcept;
+
+    /**
+     * @brief Return the number of contacts of the last pass kept by retain() instead of being tested again
+     */
+    [[nodiscard]]
+    size_t get_retained() const noexcept;
+
+    /**
+     * @brief Return the number of events dropped because the queue was full
+     */
+    [[nodiscard]]
+    size_t get_dropped() const noexcept;
+
+private:
+    /**
+     * @brief Contact of a pass, sorted by key once the pass is over
+     */
+    struct Contact
+    {
+        uint64_t key{}; // Smaller entity id in the high bits
+        ContactEvent event{};
+    };
+
+    /**
+     * @brief Return the key of an unordered pair
+     */
+    [[nodiscard]]
+    static uint64_t make_key(const Entity &a, const Entity &b) noexcept;
+
+    /**
+     * @brief Return the contact seen from the given entity, a is the entity and the normal goes from b to a
+     */
+    [[nodiscard]]
+    static ContactEvent seen_from(const ContactEvent &event, const Entity &entity) noexcept;
+
+    /**
+     * @brief Find the contact of the pair in the previous pass, nullptr if there is none
+     */
+    [[nodiscard]]
+    const Contact *find_previous(uint64_t key, const Entity &a, const Entity &b) const noexcept;
+
+    /**
+     * @brief Add an event to the ring buffer, or drop it if it is full
+     */
+    void push(const ContactEvent &event) noexcept;
+
+private:
+    std::vector<ContactEvent> m_events{}; // Ring buffer, its size is the capacity
+    size_t m_head{};                      // Oldest event
+    size_t m_size{};
+    size_t m_dropped{};
+    size_t m_retained{};                  // Contacts retained in the current pass
+    std::vector<Contact> m_previous{};    // Sorted by key
+    std::vector<Contact> m_current{};
+};
+
+/* TEMPLATE FUNCTIONS HERE */
+
+template <typename F>
+void ContactQueue::for_each_contact(const Entity &entity, F &&function) const
+{
+    for (const auto &contact : m_current)
+    {
+        if (contact.event.a == entity || contact.event.b == entity)
+        {
+            function(seen_from(contact.event, entity));
+        }
+    }
+}
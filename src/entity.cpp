@@ -1,26 +1,44 @@
-#include "entity.hpp"
+#include "entity_manager.hpp"
 
-Entity::Entity(std::string tag, size_t id) noexcept
-    : m_tag(std::move(tag)), m_id(id)
+Entity::Entity(EntityManager *manager, EntityHandle handle) noexcept
+    : m_manager(manager), m_handle(handle)
 {
 }
 
 size_t Entity::id() const noexcept
 {
-    return m_id;
+    return m_handle.index;
+}
+
+EntityHandle Entity::handle() const noexcept
+{
+    return m_handle;
+}
+
+bool Entity::is_valid() const noexcept
+{
+    return m_manager != nullptr && m_manager->is_valid(m_handle);
 }
 
 bool Entity::is_alive() const noexcept
 {
-    return m_alive;
+    return is_valid() && m_manager->is_alive(m_handle);
 }
 
-const std::string &Entity::tag() const noexcept
+Tag Entity::tag() const noexcept
 {
-    return m_tag;
+    return is_valid() ? m_manager->get_tag(m_handle) : Tag::Default;
 }
 
-void Entity::destroy() noexcept
+uint64_t Entity::spawn_order() const noexcept
 {
-    m_alive = false;
-}
\ No newline at end of file
+    return is_valid() ? m_manager->get_spawn_order(m_handle) : 0;
+}
+
+void Entity::destroy() const noexcept
+{
+    if (is_valid())
+    {
+        m_manager->destroy(m_handle);
+    }
+}
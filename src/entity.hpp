@@ -1,29 +1,58 @@
 #pragma once
 
-#include <tuple>
-#include "components.hpp"
+#include <cstdint>
+#include <limits>
+#include "component_pool.hpp"
+#include "tag.hpp"
 
-using ComponentTuple = std::tuple<CTransform, CLifeSpan, CInput, CBoundingBox, CAnimation, CGravity, CState, CJump, CSound, CBoundingConvex>;
+class EntityManager;
+
+/**
+ * @brief Generational handle identifying an entity slot in its EntityManager.
+ *
+ * The index is the slot of the entity, it is reused once the entity is removed.
+ * The generation is increased each time the slot is released,
+ * so a handle to a removed entity never matches the entity that reuses its slot.
+ */
+struct EntityHandle
+{
+    uint32_t index{std::numeric_limits<uint32_t>::max()};
+    uint32_t generation{};
+
+    /**
+     * @brief Compare two handles
+     */
+    [[nodiscard]]
+    bool operator==(const EntityHandle &) const noexcept = default;
+};
 
 /**
  * @brief Represents a single entity.
- * 
+ *
  * Each entity can have multiple components which define its data and behavior.
- * 
+ *
  * The class provides methods to add, remove and access components.
- * It also stored a unique id, a tag and an alive/dead status.
- * 
- * Entites are managed by the EntityManager class and are non-movable and non-copyable.
+ * It also gives access to the id, the tag and the alive/dead status of the entity.
+ *
+ * An Entity is a lightweight value: a generational handle plus a pointer to its EntityManager.
+ * Components, tag and status are stored in the EntityManager, so copying an entity is cheap
+ * and a copy kept after the entity has been removed is detected as invalid.
+ *
+ * Entities are created by the EntityManager class, a default constructed entity is a null handle.
  *
  * Usage:
- * 
+ *
  * - add<T>(...) to attach a component of type T
- * 
+ *
  * - has<T>() to check component
- * 
- * - get<T>() to access a component 
- * 
+ *
+ * - get<T>() to access a component
+ *
+ * - mark_changed<T>() after modifying a component, changed_since<T>(tick) to skip unchanged data
+ *
  * - destroy() to mark the entity as dead
+ *
+ * - is_valid() to check if the handle still refers to an entity stored in the manager
  */
 class Entity
 {
@@ -31,24 +60,24 @@ class Entity
 
 public:
     /**
-     * @brief Add a component to the entity
+     * @brief Default constructor, create a null handle
      */
-    template <typename T, typename... Args>
-    void add(Args &&...args);
+    explicit Entity() noexcept = default;
 
     /**
-     * @brief Return the entity component
+     * @brief Add a component to the entity
      */
-    template <typename T>
-    [[nodiscard]]
-    T &get() noexcept;
+    template <typename T, typename... Args>
+    void add(Args &&...args) const;
 
     /**
      * @brief Return the entity component
+     *
+     * @note The entity must have the component, check it with has<T>()
      */
     template <typename T>
     [[nodiscard]]
-    const T &get() const noexcept;
+    T &get() const noexcept;
 
     /**
      * @brief Check if the entity has the given component type
@@ -61,14 +90,45 @@ public:
      * @brief Remove a component
      */
     template <typename T>
-    void remove() noexcept;
+    void remove() const noexcept;
+
+    /**
+     * @brief Record that the component changed during the current tick
+     *
+     * @note The entity must have the component
+     */
+    template <typename T>
+    void mark_changed() const noexcept;
 
     /**
-     * @brief Return entity's id
+     * @brief Check if the component changed after the given tick
+     *
+     * @param tick Tick of the EntityManager
+     *
+     * @note The entity must have the component
+     */
+    template <typename T>
+    [[nodiscard]]
+    bool changed_since(uint32_t tick) const noexcept;
+
+    /**
+     * @brief Return entity's id, which is its slot index in the manager
      */
     [[nodiscard]]
     size_t id() const noexcept;
 
+    /**
+     * @brief Return entity's handle
+     */
+    [[nodiscard]]
+    EntityHandle handle() const noexcept;
+
+    /**
+     * @brief Check if the handle still refers to an entity stored in the manager
+     */
+    [[nodiscard]]
+    bool is_valid() const noexcept;
+
     /**
      * @brief Check if entity is alive
      */
@@ -79,71 +139,37 @@ public:
      * @brief Return entity's tag
      */
     [[nodiscard]]
-    const std::string &tag() const noexcept;
+    Tag tag() const noexcept;
+
+    /**
+     * @brief Return the number of entities added before this one, 0 for an invalid entity
+     */
+    [[nodiscard]]
+    uint64_t spawn_order() const noexcept;
 
     /**
      * @brief Kill / Destroy the entity
      */
-    void destroy() noexcept;
+    void destroy() const noexcept;
 
-private:
     /**
-     * @brief Default constructor
+     * @brief Compare two entities
      */
-    explicit Entity() noexcept = default;
+    [[nodiscard]]
+    bool operator==(const Entity &) const noexcept = default;
 
+private:
     /**
      * @brief Create a new entity
-     * 
-     * @param tag Entity's tag
-     * @param id  Entity's id
+     *
+     * @param manager Manager storing the entity
+     * @param handle Entity's handle
      */
-    explicit Entity(std::string tag, size_t id) noexcept;
-
-    /* Delete move and copy */
-    Entity(const Entity &) noexcept = delete;
-    Entity &operator=(const Entity &) noexcept = delete;
-    Entity(Entity &&) noexcept = delete;
-    Entity &operator=(Entity &&) noexcept = delete;
+    explicit Entity(EntityManager *manager, EntityHandle handle) noexcept;
 
 private:
-    ComponentTuple m_components{};
-    bool m_alive{true};
-    const std::string m_tag{"default"};
-    const size_t m_id{};
+    EntityManager *m_manager{};
+    EntityHandle m_handle{};
 };
 
-/* TEMPLATE FUNCTIONS HERE */
-
-template <typename T, typename... Args>
-void Entity::add(Args &&...args)
-{
-    auto &component = get<T>();
-    component = T(std::forward<Args>(args)...);
-    component.exists = true;
-    std::get<T>(m_components) = component;
-}
-
-template <typename T>
-T &Entity::get() noexcept
-{
-    return std::get<T>(m_components);
-}
-
-template <typename T>
-const T &Entity::get() const noexcept
-{
-    return std::get<T>(m_components);
-}
-
-template <typename T>
-bool Entity::has() const noexcept
-{
-    return get<T>().exists;
-}
-
-template <typename T>
-void Entity::remove() noexcept
-{
-    get<T>() = T();
-}
+/* Template functions are defined in entity_manager.hpp, they need the complete EntityManager */
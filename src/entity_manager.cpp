@@ -1,22 +1,91 @@
 #include "entity_manager.hpp"
+#include <cassert>
 
-[[nodiscard]] std::shared_ptr<Entity> EntityManager::add_entity(const std::string &tag) noexcept
+[[nodiscard]] Entity EntityManager::add_entity(Tag tag) noexcept
 {
-    const auto e{std::shared_ptr<Entity>(new Entity(tag, m_total_entities++))};
+    /* Reuse a free slot if possible */
+    uint32_t index{};
+    if (!m_free_slots.empty())
+    {
+        index = m_free_slots.back();
+        m_free_slots.pop_back();
+    }
+    else
+    {
+        index = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+
+    auto &slot{m_slots[index]};
+    slot.tag = tag;
+    slot.spawn_order = m_spawned++;
+    slot.alive = true;
+
+    const Entity e{this, EntityHandle{index, slot.generation}};
     m_entities_to_add.push_back(e);
     return e;
 }
 
+void EntityManager::reserve(size_t count)
+{
+    const size_t reused{std::min(count, m_free_slots.size())};
+    m_slots.reserve(m_slots.size() + count - reused);
+    m_entities_to_add.reserve(m_entities_to_add.size() + count);
+    m_entities.reserve(m_entities.size() + m_entities_to_add.size() + count);
+}
+
 [[nodiscard]] EntityVec &EntityManager::get_entities() noexcept
 {
     return m_entities;
 }
 
-[[nodiscard]] EntityVec &EntityManager::get_entities(const std::string &tag) noexcept
+[[nodiscard]] EntityVec &EntityManager::get_entities(Tag tag) noexcept
+{
+    return m_entity_map[static_cast<size_t>(tag)];
+}
+
+[[nodiscard]] Entity EntityManager::get_entity(size_t id) noexcept
+{
+    if (id >= m_slots.size() || !m_slots[id].alive)
+    {
+        return Entity{};
+    }
+    return Entity{this, EntityHandle{static_cast<uint32_t>(id), m_slots[id].generation}};
+}
+
+[[nodiscard]] bool EntityManager::is_valid(EntityHandle handle) const noexcept
+{
+    return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation;
+}
+
+[[nodiscard]] bool EntityManager::is_alive(EntityHandle handle) const noexcept
+{
+    return m_slots[handle.index].alive;
+}
+
+[[nodiscard]] Tag EntityManager::get_tag(EntityHandle handle) const noexcept
+{
+    return m_slots[handle.index].tag;
+}
+
+[[nodiscard]] uint64_t EntityManager::get_spawn_order(EntityHandle handle) const noexcept
+{
+    return m_slots[handle.index].spawn_order;
+}
+
+void EntityManager::destroy(EntityHandle handle) noexcept
 {
-    static EntityVec empty{};
-    auto it{m_entity_map.find(tag)};
-    return it != m_entity_map.end() ? it->second : empty;
+    auto &slot{m_slots[handle.index]};
+    if (slot.alive)
+    {
+        slot.alive = false;
+        m_dead_slots.push_back(handle.index);
+    }
+}
+
+[[nodiscard]] uint32_t EntityManager::get_tick() const noexcept
+{
+    return m_tick;
 }
 
 [[nodiscard]] const EntityMap &EntityManager::get_entity_map() const noexcept
@@ -26,28 +95,118 @@
 
 void EntityManager::update() noexcept
 {
+    m_tick++;
+
     // Add entities from the queue in the main containers
     for (const auto &e : m_entities_to_add)
     {
+        auto &slot{m_slots[e.id()]};
+        auto &bucket{m_entity_map[static_cast<size_t>(slot.tag)]};
+
+        slot.entities_position = m_entities.size();
+        slot.tag_position = bucket.size();
         m_entities.push_back(e);
-        m_entity_map[e->tag()].push_back(e);
+        bucket.push_back(e);
     }
     m_entities_to_add.clear();
 
-    // Remove dead entities from m_entities
-    remove_dead_entities(m_entities);
+    // Remove only the entities destroyed since the last update, their handles become invalid
+    for (const auto index : m_dead_slots)
+    {
+        release(index);
+    }
+    m_dead_slots.clear();
+}
+
+void EntityManager::release(uint32_t index) noexcept
+{
+    auto &slot{m_slots[index]};
+
+    /* Swap with the last entity of m_entities */
+    const Entity last{m_entities.back()};
+    m_entities[slot.entities_position] = last;
+    m_slots[last.id()].entities_position = slot.entities_position;
+    m_entities.pop_back();
+
+    /* Swap with the last entity of the tag bucket */
+    auto &bucket{m_entity_map[static_cast<size_t>(slot.tag)]};
+    const Entity last_in_bucket{bucket.back()};
+    bucket[slot.tag_position] = last_in_bucket;
+    m_slots[last_in_bucket.id()].tag_position = slot.tag_position;
+    bucket.pop_back();
+
+    /* Components */
+    set_mask(index, 0);
+    std::apply([index](auto &...pool)
+               { (pool.remove(index), ...); },
+               m_pools);
 
-    // Iterate over entity map and remove dead entities from each vector
-    for (auto &[tag, vec] : m_entity_map)
+    slot.generation++;
+    m_free_slots.push_back(index);
+}
+
+void EntityManager::set_mask(uint32_t index, ComponentMask mask) noexcept
+{
+    auto &slot{m_slots[index]};
+
+    for (auto &query : m_queries)
     {
-        remove_dead_entities(vec);
+        const bool was_matching{(slot.mask & query.mask) == query.mask};
+        const bool is_matching{(mask & query.mask) == query.mask};
+
+        /* Entity enters the query */
+        if (!was_matching && is_matching)
+        {
+            if (index >= query.positions.size())
+            {
+                query.positions.resize(index + 1, npos);
+            }
+            query.positions[index] = query.entities.size();
+            query.entities.push_back(Entity{this, EntityHandle{index, slot.generation}});
+        }
+
+        /* Entity leaves the query, swap it with the last one */
+        else if (was_matching && !is_matching)
+        {
+            const size_t position{query.positions[index]};
+            const Entity last{query.entities.back()};
+            query.entities[position] = last;
+            query.positions[last.id()] = position;
+            query.entities.pop_back();
+            query.positions[index] = npos;
+        }
     }
+
+    slot.mask = mask;
 }
 
-void EntityManager::remove_dead_entities(EntityVec &vec) noexcept
+void EntityManager::set_queries_locked(bool locked) noexcept
 {
-    vec.erase(std::remove_if(vec.begin(), vec.end(),
-                             [](const std::shared_ptr<Entity> &e)
-                             { return !e->is_alive(); }),
-              vec.end());
+    m_queries_locked = locked;
 }
+
+const EntityVec &EntityManager::get_query(ComponentMask mask) noexcept
+{
+    for (const auto &query : m_queries)
+    {
+        if (query.mask == mask)
+        {
+            return query.entities;
+        }
+    }
+
+    /* First time this query is used, fill it with the current entities. Other threads may be reading m_queries while systems run */
+    assert(!m_queries_locked && "Query built while systems run in parallel, build it before running the scheduler");
+    auto &query{m_queries.emplace_back()};
+    query.mask = mask;
+    query.positions.resize(m_slots.size(), npos);
+    for (uint32_t i = 0; i < m_slots.size(); ++i)
+    {
+        if ((m_slots[i].mask & mask) == mask)
+        {
+            query.positions[i] = query.entities.size();
+            query.entities.push_back(Entity{this, EntityHandle{i, m_slots[i].generation}});
+        }
+    }
+    return query.entities;
+}
\ No newline at end of file
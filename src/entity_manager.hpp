@@ -1,37 +1,51 @@
 #pragma once
 
 #include <vector>
-#include <unordered_map>
-#include <memory>
+#include <array>
+#include <deque>
 #include <algorithm>
 #include "entity.hpp"
 
-using EntityVec = std::vector<std::shared_ptr<Entity>>;
-using EntityMap = std::unordered_map<std::string, EntityVec>;
+using EntityVec = std::vector<Entity>;
+using EntityMap = std::array<EntityVec, tag_count>;
 
 /**
  * @brief Manages all entities within a scene.
- * 
+ *
  * The EntityManager is responsible for creating, storing, updating and removing entities.
- * 
- * The Manager keeps track of: 
- * 
+ *
+ * The Manager keeps track of:
+ *
  * - active entities
- * 
+ *
  * - entities pending addition
- * 
- * - a map for lookup by tag or id
- * 
+ *
+ * - one bucket of entities per tag, indexed by the tag value
+ *
+ * - one dense pool per component type, shared by all its entities
+ *
+ * - one slot per entity, holding its tag, alive status, generation and component mask
+ *
+ * - cached queries: lists of the entities that have a given set of components
+ *
  * Usage:
- * 
+ *
  * - add_entity(tag): Create and store a new entity with a unique id, and give it a tag for fast retrieval of entities of the same type
- * 
+ *
  * - get_entities(): Access entities, can be filtered by tag
- * 
+ *
+ * - get_pool<T>(): Access the dense array of all components of type T, for systems that only need this component
+ *
+ * - query<Ts...>(): Access the entities that have all the components Ts, the list is updated when components are added or removed
+ *
+ * - get_changed<T>(tick, out): Access the entities whose component T changed after the given tick
+ *
  * - update(): Update entities and clean up dead ones
- * 
- * 
+ *
+ *
  * @note Each scene owns it own EntityManager, copy or move this class between scenes is not possible.
+ * @note Slots of removed entities are reused, their generation is increased so that old handles become invalid.
+ * @note The tick is increased by each update, a component added or marked as changed stores the current tick.
  */
 class EntityManager
 {
@@ -51,10 +65,17 @@ public:
     /**
      * @brief Add an entity with the given tag
      *
-     * @param tag Entity's tag / name
+     * @param tag Entity's tag
      */
     [[nodiscard]]
-    std::shared_ptr<Entity> add_entity(const std::string &tag) noexcept;
+    Entity add_entity(Tag tag) noexcept;
+
+    /**
+     * @brief Reserve room for the given number of new entities, so that adding them does not reallocate
+     *
+     * @param count Number of entities that will be added
+     */
+    void reserve(size_t count);
 
     /**
      * @brief Return all entities
@@ -68,10 +89,154 @@ public:
      * @param tag Entities tag
      */
     [[nodiscard]]
-    EntityVec &get_entities(const std::string &tag) noexcept;
+    EntityVec &get_entities(Tag tag) noexcept;
+
+    /**
+     * @brief Return the entity stored in the given slot, or a null entity if the slot is free
+     *
+     * @param id Entity's id / slot index
+     */
+    [[nodiscard]]
+    Entity get_entity(size_t id) noexcept;
+
+    /**
+     * @brief Check if the handle refers to an entity stored in the manager
+     *
+     * @param handle Entity's handle
+     */
+    [[nodiscard]]
+    bool is_valid(EntityHandle handle) const noexcept;
+
+    /**
+     * @brief Check if the entity is alive
+     *
+     * @param handle Entity's handle, must be valid
+     */
+    [[nodiscard]]
+    bool is_alive(EntityHandle handle) const noexcept;
+
+    /**
+     * @brief Return the tag of the entity
+     *
+     * @param handle Entity's handle, must be valid
+     */
+    [[nodiscard]]
+    Tag get_tag(EntityHandle handle) const noexcept;
+
+    /**
+     * @brief Return the number of entities added before this one, unlike the id it is never reused
+     *
+     * @param handle Entity's handle, must be valid
+     */
+    [[nodiscard]]
+    uint64_t get_spawn_order(EntityHandle handle) const noexcept;
+
+    /**
+     * @brief Mark the entity as dead, it will be removed on the next update
+     *
+     * Dead entities are recorded, so the update only has to visit the entities destroyed since the last update.
+     *
+     * @param handle Entity's handle, must be valid
+     */
+    void destroy(EntityHandle handle) noexcept;
+
+    /**
+     * @brief Add a component to the entity, replace it if the entity already has one
+     *
+     * @param handle Entity's handle
+     * @param args Arguments forwarded to the component constructor
+     */
+    template <typename T, typename... Args>
+    void add_component(EntityHandle handle, Args &&...args);
+
+    /**
+     * @brief Remove a component from the entity
+     *
+     * @param handle Entity's handle
+     */
+    template <typename T>
+    void remove_component(EntityHandle handle) noexcept;
+
+    /**
+     * @brief Check if the entity has the component, using its component mask
+     *
+     * @param handle Entity's handle
+     */
+    template <typename T>
+    [[nodiscard]]
+    bool has_component(EntityHandle handle) const noexcept;
+
+    /**
+     * @brief Return the entities that have all the given components
+     *
+     * The list is built on the first call, then kept up to date each time a component is added or removed.
+     *
+     * @note Order of the entities is not preserved when an entity leaves the list
+     * @note Do not add or remove the queried components while iterating over the list
+     * @note Building a list is not thread safe, systems running in parallel must only use lists built beforehand
+     */
+    template <typename... Ts>
+    [[nodiscard]]
+    const EntityVec &query() noexcept;
 
     /**
-     * @brief Return the entity map
+     * @brief Forbid or allow building new query lists, existing lists can still be read.
+     *
+     * Set while systems run in parallel, building a list then asserts in debug builds.
+     *
+     * @param locked True to forbid new lists
+     */
+    void set_queries_locked(bool locked) noexcept;
+
+    /**
+     * @brief Record that the component of the entity changed during the current tick
+     *
+     * @param handle Entity's handle, the entity must have the component
+     */
+    template <typename T>
+    void mark_changed(EntityHandle handle) noexcept;
+
+    /**
+     * @brief Check if the component of the entity changed after the given tick
+     *
+     * @param handle Entity's handle, the entity must have the component
+     * @param tick Tick to compare with
+     */
+    template <typename T>
+    [[nodiscard]]
+    bool changed_since(EntityHandle handle, uint32_t tick) const noexcept;
+
+    /**
+     * @brief Fill the given vector with the entities whose component T changed after the given tick
+     *
+     * @param tick Tick to compare with
+     * @param out Output, cleared first, reuse it between calls to avoid allocations
+     */
+    template <typename T>
+    void get_changed(uint32_t tick, EntityVec &out);
+
+    /**
+     * @brief Return the current tick
+     */
+    [[nodiscard]]
+    uint32_t get_tick() const noexcept;
+
+    /**
+     * @brief Return the pool storing all components of type T
+     */
+    template <typename T>
+    [[nodiscard]]
+    ComponentPool<T> &get_pool() noexcept;
+
+    /**
+     * @brief Return the pool storing all components of type T
+     */
+    template <typename T>
+    [[nodiscard]]
+    const ComponentPool<T> &get_pool() const noexcept;
+
+    /**
+     * @brief Return the entity map, one bucket of entities per tag
      */
     [[nodiscard]]
     const EntityMap &get_entity_map() const noexcept;
@@ -83,15 +248,188 @@ public:
 
 private:
     /**
-     * @brief Remove dead entities from the entity manager
-     * 
-     * @param vec Entities to remove
+     * @brief Slot data of an entity
+     */
+    struct EntitySlot
+    {
+        Tag tag{Tag::Default};
+        uint32_t generation{};
+        uint64_t spawn_order{};
+        ComponentMask mask{};
+        size_t entities_position{}; // Position in m_entities
+        size_t tag_position{};      // Position in the bucket of its tag
+        bool alive{false};
+    };
+
+    /**
+     * @brief Cached list of the entities matching a component mask
      */
-    void remove_dead_entities(EntityVec &vec) noexcept;
+    struct Query
+    {
+        ComponentMask mask{};
+        EntityVec entities{};
+        std::vector<size_t> positions{}; // Position in entities of each slot, npos if not in the list
+    };
+
+    /**
+     * @brief Remove the entity from the containers, remove every component of the entity and free its slot
+     *
+     * The entity is swapped with the last entity of each container, so the cost does not depend on the number of entities.
+     *
+     * @param index Entity's slot index
+     */
+    void release(uint32_t index) noexcept;
+
+    /**
+     * @brief Change the component mask of an entity and add it to / remove it from the cached queries
+     *
+     * @param index Entity's slot index
+     * @param mask New component mask
+     */
+    void set_mask(uint32_t index, ComponentMask mask) noexcept;
+
+    /**
+     * @brief Return the cached query for the given mask, create it if needed
+     *
+     * @param mask Component mask
+     */
+    [[nodiscard]]
+    const EntityVec &get_query(ComponentMask mask) noexcept;
 
 private:
+    static constexpr size_t npos{std::numeric_limits<size_t>::max()};
+
     EntityVec m_entities{};
     EntityVec m_entities_to_add{};
     EntityMap m_entity_map{};
-    size_t m_total_entities{};
+    ComponentPools m_pools{};
+    std::vector<EntitySlot> m_slots{};
+    std::vector<uint32_t> m_free_slots{};
+    std::vector<uint32_t> m_dead_slots{};
+    std::deque<Query> m_queries{};
+    bool m_queries_locked{false};
+    uint32_t m_tick{1};
+    uint64_t m_spawned{}; // Entities added since the manager was created
 };
+
+/* TEMPLATE FUNCTIONS HERE */
+
+template <typename T>
+ComponentPool<T> &EntityManager::get_pool() noexcept
+{
+    return std::get<ComponentPool<T>>(m_pools);
+}
+
+template <typename T>
+const ComponentPool<T> &EntityManager::get_pool() const noexcept
+{
+    return std::get<ComponentPool<T>>(m_pools);
+}
+
+template <typename T, typename... Args>
+void EntityManager::add_component(EntityHandle handle, Args &&...args)
+{
+    if (!is_valid(handle)) [[unlikely]]
+    {
+        return;
+    }
+
+    auto &pool{get_pool<T>()};
+    pool.emplace(handle.index, std::forward<Args>(args)...);
+    pool.mark_changed(handle.index, m_tick);
+    set_mask(handle.index, m_slots[handle.index].mask | component_bit<T>());
+}
+
+template <typename T>
+void EntityManager::remove_component(EntityHandle handle) noexcept
+{
+    if (!has_component<T>(handle))
+    {
+        return;
+    }
+
+    get_pool<T>().remove(handle.index);
+    set_mask(handle.index, m_slots[handle.index].mask & ~component_bit<T>());
+}
+
+template <typename T>
+bool EntityManager::has_component(EntityHandle handle) const noexcept
+{
+    return is_valid(handle) && (m_slots[handle.index].mask & component_bit<T>()) != 0;
+}
+
+template <typename T>
+void EntityManager::mark_changed(EntityHandle handle) noexcept
+{
+    get_pool<T>().mark_changed(handle.index, m_tick);
+}
+
+template <typename T>
+bool EntityManager::changed_since(EntityHandle handle, uint32_t tick) const noexcept
+{
+    return get_pool<T>().get_tick(handle.index) > tick;
+}
+
+template <typename T>
+void EntityManager::get_changed(uint32_t tick, EntityVec &out)
+{
+    out.clear();
+
+    /* Only the tick array is read, components of unchanged entities are not touched */
+    const auto &pool{get_pool<T>()};
+    const auto &ticks{pool.ticks()};
+    for (size_t i = 0; i < ticks.size(); ++i)
+    {
+        if (ticks[i] > tick)
+        {
+            const size_t id{pool.entities()[i]};
+            out.push_back(Entity{this, EntityHandle{static_cast<uint32_t>(id), m_slots[id].generation}});
+        }
+    }
+}
+
+template <typename... Ts>
+const EntityVec &EntityManager::query() noexcept
+{
+    static_assert(sizeof...(Ts) > 0, "A query needs at least one component");
+    return get_query(component_mask<Ts...>());
+}
+
+template <typename T, typename... Args>
+void Entity::add(Args &&...args) const
+{
+    m_manager->add_component<T>(m_handle, std::forward<Args>(args)...);
+}
+
+template <typename T>
+T &Entity::get() const noexcept
+{
+    return m_manager->get_pool<T>().get(m_handle.index);
+}
+
+template <typename T>
+bool Entity::has() const noexcept
+{
+    return m_manager != nullptr && m_manager->has_component<T>(m_handle);
+}
+
+template <typename T>
+void Entity::mark_changed() const noexcept
+{
+    m_manager->mark_changed<T>(m_handle);
+}
+
+template <typename T>
+bool Entity::changed_since(uint32_t tick) const noexcept
+{
+    return m_manager->changed_since<T>(m_handle, tick);
+}
+
+template <typename T>
+void Entity::remove() const noexcept
+{
+    if (m_manager != nullptr)
+    {
+        m_manager->remove_component<T>(m_handle);
+    }
+}
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <cstdint>
+#include <compare>
+#include <limits>
+
+/**
+ * @brief Signed 48.16 fixed-point number: 48 bits of integer part, 16 bits of fraction, in an int64_t.
+ *
+ * Every operation is done on integers, so results are the same bit for bit with any compiler, optimisation level or CPU,
+ * unlike float math where contractions (fused multiply-add), extended precision and reordering may change the last bits.
+ *
+ * The range is [-2^47, 2^47) with a step of 1/65536, far beyond the coordinates of any level (a float component
+ * already loses sub-pixel precision past 2^24). Additions wrap around on overflow, products and quotients are computed
+ * exactly on split 64 bits words, without a 128 bits type, and rounded toward negative infinity.
+ *
+ * Usage:
+ *
+ * - Fixed::from_float(value) / to_float(): Convert from and to float, both conversions are exact or correctly rounded
+ *
+ * - Fixed::from_int(value) / Fixed::from_raw(bits): Build from an integer, or from the raw 48.16 bits
+ *
+ * - Arithmetic and comparison operators, abs(value)
+ */
+class Fixed
+{
+public:
+    static constexpr int64_t fraction_bits{16};
+    static constexpr int64_t one{int64_t{1} << fraction_bits};
+
+    /**
+     * @brief Zero
+     */
+    explicit constexpr Fixed() noexcept = default;
+
+    /**
+     * @brief Build from the raw 48.16 bits
+     *
+     * @param raw Value multiplied by 65536
+     */
+    [[nodiscard]]
+    static constexpr Fixed from_raw(int64_t raw) noexcept;
+
+    /**
+     * @brief Build from an integer
+     *
+     * @param value Integer
+     */
+    [[nodiscard]]
+    static constexpr Fixed from_int(int32_t value) noexcept;
+
+    /**
+     * @brief Convert a float, rounded to the nearest step, half away from zero, saturated to the range
+     *
+     * @param value Float
+     */
+    [[nodiscard]]
+    static constexpr Fixed from_float(float value) noexcept;
+
+    /**
+     * @brief Return the largest value
+     */
+    [[nodiscard]]
+    static constexpr Fixed max() noexcept;
+
+    /**
+     * @brief Return the smallest value
+     */
+    [[nodiscard]]
+    static constexpr Fixed lowest() noexcept;
+
+    /**
+     * @brief Convert to float, rounded to the nearest float above 256
+     */
+    [[nodiscard]]
+    constexpr float to_float() const noexcept;
+
+    /**
+     * @brief Return the raw 48.16 bits
+     */
+    [[nodiscard]]
+    constexpr int64_t raw() const noexcept;
+
+    constexpr Fixed &operator+=(Fixed other) noexcept;
+    constexpr Fixed &operator-=(Fixed other) noexcept;
+    constexpr Fixed &operator*=(Fixed other) noexcept;
+    constexpr Fixed &operator/=(Fixed other) noexcept;
+
+    [[nodiscard]]
+    friend constexpr Fixed operator+(Fixed a, Fixed b) noexcept { return a += b; }
+    [[nodiscard]]
+    friend constexpr Fixed operator-(Fixed a, Fixed b) noexcept { return a -= b; }
+    [[nodiscard]]
+    friend constexpr Fixed operator*(Fixed a, Fixed b) noexcept { return a *= b; }
+    [[nodiscard]]
+    friend constexpr Fixed operator/(Fixed a, Fixed b) noexcept { return a /= b; }
+    [[nodiscard]]
+    friend constexpr Fixed operator-(Fixed a) noexcept { return Fixed{} - a; }
+    [[nodiscard]]
+    friend constexpr Fixed abs(Fixed a) noexcept { return a.m_raw < 0 ? -a : a; }
+
+    [[nodiscard]]
+    constexpr auto operator<=>(const Fixed &) const noexcept = default;
+
+private:
+    /**
+     * @brief Convert a modular 64 bits result to a signed value, the conversion is modular since C++20
+     */
+    [[nodiscard]]
+    static constexpr int64_t wrap(uint64_t value) noexcept;
+
+    /**
+     * @brief Magnitude of a raw value, the lowest value included
+     */
+    [[nodiscard]]
+    static constexpr uint64_t magnitude(int64_t value) noexcept;
+
+private:
+    int64_t m_raw{};
+};
+
+/* TEMPLATE FUNCTIONS HERE */
+
+[[nodiscard]] constexpr Fixed Fixed::from_raw(int64_t raw) noexcept
+{
+    Fixed fixed{};
+    fixed.m_raw = raw;
+    return fixed;
+}
+
+[[nodiscard]] constexpr Fixed Fixed::from_int(int32_t value) noexcept
+{
+    return from_raw(static_cast<int64_t>(value) * one);
+}
+
+[[nodiscard]] constexpr Fixed Fixed::from_float(float value) noexcept
+{
+    /* Scaling by a power of two is exact, the rounding below is the only one */
+    const float scaled{value * static_cast<float>(one)};
+    if (!(scaled < static_cast<float>(std::numeric_limits<int64_t>::max())))
+    {
+        return scaled != scaled ? Fixed{} : max(); // NaN is 0
+    }
+    if (scaled <= static_cast<float>(std::numeric_limits<int64_t>::min()))
+    {
+        return lowest();
+    }
+
+    const auto truncated{static_cast<int64_t>(scaled)};
+    const float fraction{scaled - static_cast<float>(truncated)};
+    const int64_t rounding{fraction >= 0.5f ? 1 : (fraction <= -0.5f ? -1 : 0)};
+    return from_raw(truncated + rounding);
+}
+
+[[nodiscard]] constexpr Fixed Fixed::max() noexcept
+{
+    return from_raw(std::numeric_limits<int64_t>::max());
+}
+
+[[nodiscard]] constexpr Fixed Fixed::lowest() noexcept
+{
+    return from_raw(std::numeric_limits<int64_t>::min());
+}
+
+[[nodiscard]] constexpr float Fixed::to_float() const noexcept
+{
+    return static_cast<float>(m_raw) / static_cast<float>(one);
+}
+
+[[nodiscard]] constexpr int64_t Fixed::raw() const noexcept
+{
+    return m_raw;
+}
+
+constexpr Fixed &Fixed::operator+=(Fixed other) noexcept
+{
+    m_raw = wrap(static_cast<uint64_t>(m_raw) + static_cast<uint64_t>(other.m_raw));
+    return *this;
+}
+
+constexpr Fixed &Fixed::operator-=(Fixed other) noexcept
+{
+    m_raw = wrap(static_cast<uint64_t>(m_raw) - static_cast<uint64_t>(other.m_raw));
+    return *this;
+}
+
+constexpr Fixed &Fixed::operator*=(Fixed other) noexcept
+{
+    /* a = ah * 2^16 + al with 0 <= al < 2^16 (arithmetic shift since C++20), same for b, then
+       (a * b) >> 16 = ah * bh * 2^16 + ah * bl + al * bh + ((al * bl) >> 16), the last shift is the only rounding */
+    const int64_t a_high{m_raw >> fraction_bits};
+    const int64_t b_high{other.m_raw >> fraction_bits};
+    const uint64_t a_low{static_cast<uint64_t>(m_raw) & (one - 1)};
+    const uint64_t b_low{static_cast<uint64_t>(other.m_raw) & (one - 1)};
+
+    uint64_t result{static_cast<uint64_t>(a_high) * static_cast<uint64_t>(b_high) << fraction_bits};
+    result += static_cast<uint64_t>(a_high) * b_low;
+    result += a_low * static_cast<uint64_t>(b_high);
+    result += (a_low * b_low) >> fraction_bits;
+    m_raw = wrap(result);
+    return *this;
+}
+
+constexpr Fixed &Fixed::operator/=(Fixed other) noexcept
+{
+    /* Division by zero saturates, toward the sign of the dividend */
+    if (other.m_raw == 0)
+    {
+        *this = m_raw < 0 ? lowest() : max();
+        return *this;
+    }
+
+    /* Long division of the magnitudes: the integer part, then one bit of fraction at a time.
+       The remainder stays below the divisor, at most 2^63, so doubling it fits in 64 bits */
+    const uint64_t numerator{magnitude(m_raw)};
+    const uint64_t divisor{magnitude(other.m_raw)};
+    uint64_t quotient{numerator / divisor};
+    uint64_t remainder{numerator % divisor};
+    for (int64_t bit = 0; bit < fraction_bits; ++bit)
+    {
+        remainder <<= 1;
+        quotient <<= 1;
+        if (remainder >= divisor)
+        {
+            remainder -= divisor;
+            quotient |= 1;
+        }
+    }
+
+    /* Round toward negative infinity, like the product */
+    const bool negative{(m_raw < 0) != (other.m_raw < 0)};
+    if (negative)
+    {
+        quotient = remainder != 0 ? ~quotient : ~quotient + 1; // -quotient, minus one if inexact
+    }
+    m_raw = wrap(quotient);
+    return *this;
+}
+
+[[nodiscard]] constexpr int64_t Fixed::wrap(uint64_t value) noexcept
+{
+    return static_cast<int64_t>(value);
+}
+
+[[nodiscard]] constexpr uint64_t Fixed::magnitude(int64_t value) noexcept
+{
+    return value < 0 ? ~static_cast<uint64_t>(value) + 1 : static_cast<uint64_t>(value);
+}
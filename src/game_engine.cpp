@@ -3,6 +3,7 @@
 #include "scene.hpp"
 #include "scene_menu.hpp"
 #include <iostream>
+#include <algorithm>
 #include <imgui.h>
 #include <imgui-SFML.h>
 
@@ -25,11 +26,15 @@ void GameEngine::init()
         m_assets.add_font(font.name, font.path);
     }
 
+    /* Sounds are decoded on the workers while the textures are loaded, the main thread does all the printing */
+    const auto sounds{m_jobs.schedule([this]()
+                                      { m_assets.add_sounds(m_jobs, m_config.get_sound_config()); })};
+
     for (const auto &texture : m_config.get_texture_config())
     {
         std::cout << std::format("Adding texture {}\n", texture.name);
-        m_assets.add_texture(texture.name, texture.path);
     }
+    m_assets.add_textures(m_jobs, m_config.get_texture_config());
 
     for (const auto &animation : m_config.get_animation_config())
     {
@@ -38,10 +43,10 @@ void GameEngine::init()
         m_assets.add_animation(animation.name, anim);
     }
 
-    for (const auto &sound: m_config.get_sound_config())
+    m_jobs.wait(sounds);
+    for (const auto &sound : m_config.get_sound_config())
     {
         std::cout << std::format("Adding sound {}\n", sound.name);
-        m_assets.add_sound(sound.name, sound.path);
     }
 
     for (const auto &music: m_config.get_music_config())
@@ -57,6 +62,7 @@ void GameEngine::init()
     m_window.setMinimumSize(sizes);
     m_window.setMaximumSize(sizes);
     m_window.setFramerateLimit(m_config.get_window_config().framerate);
+    m_tick_time = sf::seconds(1.0f / static_cast<float>(std::max(m_config.get_window_config().tick_rate, 1u)));
     m_window.setView(sf::View{{0.0f, 0.0f}, sizes_f});
 
     /* Init ImGui */
@@ -71,10 +77,12 @@ void GameEngine::init()
 
 void GameEngine::run()
 {
+    m_frame_clock.restart();
     while (is_running())
     {
         system_user_input();
         update();
+        render();
         m_window.display();
     }
 }
@@ -98,12 +106,46 @@ void GameEngine::change_scene(const std::string &name, const std::shared_ptr<Sce
 }
 
 void GameEngine::update()
+{
+    /* Spiral of death: ticks slower than real time would fall further behind each frame, drop the excess time */
+    sf::Time elapsed{m_frame_clock.restart()};
+    const sf::Time max_elapsed{m_tick_time * static_cast<float>(max_ticks_per_frame)};
+    if (m_accumulator + elapsed > max_elapsed)
+    {
+        const sf::Time dropped{m_accumulator + elapsed - max_elapsed};
+        m_tick_stats.dropped_ticks += static_cast<size_t>(dropped / m_tick_time);
+        m_tick_stats.clamped_frames++;
+        elapsed = max_elapsed - m_accumulator;
+    }
+    m_accumulator += elapsed;
+
+    /* The scene is fetched again each tick, a tick may change it */
+    m_tick_stats.frame_ticks = 0;
+    while (m_accumulator >= m_tick_time && is_running())
+    {
+        auto scene{get_current_scene()};
+        if (scene == nullptr) [[unlikely]]
+        {
+            break;
+        }
+
+        scene->update();
+        m_accumulator -= m_tick_time;
+        m_tick_stats.ticks++;
+        m_tick_stats.frame_ticks++;
+    }
+
+    m_tick_stats.interpolation = std::clamp(m_accumulator / m_tick_time, 0.0f, 1.0f);
+}
+
+void GameEngine::render()
 {
     auto scene{get_current_scene()};
-    if (scene != nullptr) [[likely]]
+    if (scene != nullptr && is_running()) [[likely]]
     {
         ImGui::SFML::Update(m_window, m_imgui_clock.restart());
-        scene->update();
+        scene->set_interpolation(m_tick_stats.interpolation);
+        scene->render();
         ImGui::SFML::Render(m_window);
     }
 }
@@ -159,6 +201,11 @@ AssetManager &GameEngine::get_assets() noexcept
     return m_assets;
 }
 
+JobSystem &GameEngine::get_jobs() noexcept
+{
+    return m_jobs;
+}
+
 const sf::RenderWindow &GameEngine::get_window() const noexcept
 {
     return m_window;
@@ -190,6 +237,11 @@ const BulletConfig &GameEngine::get_bullet_config() const noexcept
     return m_config.get_bullet_config();
 }
 
+const std::vector<CollisionConfig> &GameEngine::get_collision_config() const noexcept
+{
+    return m_config.get_collision_config();
+}
+
 const std::vector<LevelConfig> &GameEngine::get_level_config() const noexcept
 {
     return m_config.get_level_config();
@@ -215,6 +267,11 @@ const sf::View &GameEngine::get_view() const noexcept
     return m_window.getView();
 }
 
+const GameEngine::TickStats &GameEngine::get_tick_stats() const noexcept
+{
+    return m_tick_stats;
+}
+
 bool GameEngine::is_running() const noexcept
 {
     return m_running && m_window.isOpen();
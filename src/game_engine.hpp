@@ -4,6 +4,7 @@
 #include <SFML/System/Clock.hpp>
 #include "config_parser.hpp"
 #include "asset_manager.hpp"
+#include "job_system.hpp"
 
 class Scene;
 
@@ -20,11 +21,19 @@ using SceneMap = std::unordered_map<std::string, std::shared_ptr<Scene>>;
  * GameEngine manages the game loop, scenes, assets, config and window.
  * It serves as the entry point and controller of the application.
  * 
+ * The simulation runs at a fixed tick rate, independent of the framerate: each frame, the elapsed time is added
+ * to an accumulator and the scene is updated once per whole tick in it. The scene is then rendered once,
+ * with the remaining fraction of a tick so it can interpolate positions between the last two ticks.
+ * A slow frame runs at most max_ticks_per_frame ticks, the rest of its time is dropped instead of
+ * making the next frames even slower.
+ * 
  * Usage:
  * 
  * - run(): Start the main game loop
  * 
- * - update(): Update the game logic
+ * - update(): Run the ticks of the simulation due since the last frame
+ * 
+ * - get_tick_stats(): Number of ticks run and dropped
  * 
  * - quit(): Stop the game
  * 
@@ -33,6 +42,7 @@ using SceneMap = std::unordered_map<std::string, std::shared_ptr<Scene>>;
  * The class provides access to:
  * 
  * - AssetManager for textures, fonts, sounds, musics and animations
+ * - JobSystem to run work on every core, for scenes and asset loading
  * - Window and view for rendering
  * - Config data for window, levels, etc.
  * 
@@ -53,6 +63,20 @@ public:
         float m_sound_volume{5.0f};
     };
 
+    /**
+     * @brief Fixed tick counters, since the game started
+     */
+    struct TickStats
+    {
+        size_t ticks{};            // Ticks run
+        size_t dropped_ticks{};    // Ticks skipped because a frame took longer than max_ticks_per_frame ticks
+        size_t clamped_frames{};   // Frames that dropped ticks
+        unsigned frame_ticks{};    // Ticks run during the last frame
+        float interpolation{};     // Fraction of a tick rendered during the last frame
+    };
+
+    static constexpr unsigned max_ticks_per_frame{5};
+
     GameSettings settings{};
 
 public:
@@ -80,7 +104,7 @@ public:
     explicit GameEngine(const std::string &config_file);
 
     /**
-     * @brief Update the game each frame
+     * @brief Run the fixed ticks due since the last frame
      */
     void update();
 
@@ -116,6 +140,12 @@ public:
     [[nodiscard]]
     AssetManager &get_assets() noexcept;
 
+    /**
+     * @brief Return the job system
+     */
+    [[nodiscard]]
+    JobSystem &get_jobs() noexcept;
+
     /**
      * @brief Return the window
      */
@@ -146,6 +176,12 @@ public:
     [[nodiscard]]
     const BulletConfig &get_bullet_config() const noexcept;
 
+    /**
+     * @brief Return collision filters info
+     */
+    [[nodiscard]]
+    const std::vector<CollisionConfig> &get_collision_config() const noexcept;
+
     /**
      * @brief Return levels info (name, data file)
      */
@@ -176,6 +212,12 @@ public:
     [[nodiscard]]
     const sf::View &get_view() const noexcept;
 
+    /**
+     * @brief Return the fixed tick counters
+     */
+    [[nodiscard]]
+    const TickStats &get_tick_stats() const noexcept;
+
     /**
      * @brief Check if game is running
      */
@@ -193,6 +235,11 @@ private:
      */
     void system_user_input() noexcept;
 
+    /**
+     * @brief Render the current scene and ImGui once per frame
+     */
+    void render();
+
     /**
      * @brief Return current scene
      */
@@ -200,6 +247,7 @@ private:
     std::shared_ptr<Scene> get_current_scene() const noexcept;
 
 private:
+    JobSystem m_jobs{}; // First member, workers stop after everything that could use them is destroyed
     sf::RenderWindow m_window{};
     SceneMap m_scenes{};
     AssetManager m_assets{};
@@ -207,4 +255,8 @@ private:
     bool m_running{true};
     ConfigParser m_config{};
     sf::Clock m_imgui_clock{};
+    sf::Clock m_frame_clock{};
+    sf::Time m_tick_time{};
+    sf::Time m_accumulator{};
+    TickStats m_tick_stats{};
 };
@@ -0,0 +1,198 @@
+#include "job_system.hpp"
+
+thread_local const JobSystem *JobSystem::t_owner{nullptr};
+thread_local size_t JobSystem::t_worker{};
+
+JobSystem::JobSystem() : JobSystem(std::max(std::thread::hardware_concurrency(), 1u) - 1)
+{
+}
+
+JobSystem::JobSystem(size_t worker_count)
+{
+    /* One queue per worker, the last one is shared by the other threads */
+    for (size_t i = 0; i < worker_count + 1; ++i)
+    {
+        m_queues.push_back(std::make_unique<Queue>());
+    }
+
+    m_workers.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i)
+    {
+        m_workers.emplace_back([this, i]()
+                               { worker_loop(i); });
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard lock(m_sleep_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+
+    for (auto &worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+JobHandle JobSystem::schedule(std::function<void()> function)
+{
+    return schedule(std::move(function), {});
+}
+
+JobHandle JobSystem::schedule(std::function<void()> function, const std::vector<JobHandle> &dependencies)
+{
+    auto job{std::make_shared<Job>()};
+    job->function = std::move(function);
+
+    for (const auto &dependency : dependencies)
+    {
+        std::lock_guard lock(dependency->mutex);
+        if (!dependency->finished)
+        {
+            job->pending_dependencies++;
+            dependency->continuations.push_back(job);
+        }
+    }
+
+    /* Release the scheduling guard, the job is queued now if nothing is left to wait for */
+    if (--job->pending_dependencies == 0)
+    {
+        push(job);
+    }
+    return job;
+}
+
+JobHandle JobSystem::then(const JobHandle &job, std::function<void()> function)
+{
+    return schedule(std::move(function), {job});
+}
+
+void JobSystem::wait(const JobHandle &job)
+{
+    while (!job->finished)
+    {
+        if (!run_one())
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+[[nodiscard]] size_t JobSystem::size() const noexcept
+{
+    return m_workers.size();
+}
+
+void JobSystem::worker_loop(size_t index)
+{
+    t_owner = this;
+    t_worker = index;
+
+    while (true)
+    {
+        if (auto job{pop()})
+        {
+            execute(job);
+            continue;
+        }
+
+        /* Sleep until a job is queued, finish the queued jobs before stopping */
+        std::unique_lock lock(m_sleep_mutex);
+        m_wake.wait(lock, [this]()
+                    { return m_stop || m_queued > 0; });
+        if (m_stop && m_queued == 0)
+        {
+            return;
+        }
+    }
+}
+
+void JobSystem::push(JobHandle job)
+{
+    auto &queue{*m_queues[queue_index()]};
+    {
+        /* Counted before it is visible, pop() decrements under the same lock so the counter never goes below zero */
+        std::lock_guard lock(queue.mutex);
+        m_queued++;
+        queue.jobs.push_back(std::move(job));
+    }
+
+    /* Take the lock so a worker cannot miss the job between its check and its wait */
+    {
+        std::lock_guard lock(m_sleep_mutex);
+    }
+    m_wake.notify_one();
+}
+
+[[nodiscard]] JobHandle JobSystem::pop()
+{
+    const size_t own{queue_index()};
+
+    /* Own queue first, newest job (its data is likely still in cache) */
+    {
+        auto &queue{*m_queues[own]};
+        std::lock_guard lock(queue.mutex);
+        if (!queue.jobs.empty())
+        {
+            auto job{std::move(queue.jobs.back())};
+            queue.jobs.pop_back();
+            m_queued--;
+            return job;
+        }
+    }
+
+    /* Steal the oldest job of another queue */
+    for (size_t i = 1; i < m_queues.size(); ++i)
+    {
+        auto &queue{*m_queues[(own + i) % m_queues.size()]};
+        std::lock_guard lock(queue.mutex);
+        if (!queue.jobs.empty())
+        {
+            auto job{std::move(queue.jobs.front())};
+            queue.jobs.pop_front();
+            m_queued--;
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::execute(const JobHandle &job)
+{
+    job->function();
+
+    std::vector<JobHandle> continuations{};
+    {
+        std::lock_guard lock(job->mutex);
+        job->finished = true;
+        continuations.swap(job->continuations);
+    }
+
+    for (auto &continuation : continuations)
+    {
+        if (--continuation->pending_dependencies == 0)
+        {
+            push(std::move(continuation));
+        }
+    }
+}
+
+bool JobSystem::run_one()
+{
+    auto job{pop()};
+    if (job == nullptr)
+    {
+        return false;
+    }
+
+    execute(job);
+    return true;
+}
+
+[[nodiscard]] size_t JobSystem::queue_index() const noexcept
+{
+    return t_owner == this ? t_worker : m_workers.size();
+}
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+/**
+ * @brief Unit of work of the JobSystem, only handled through a JobHandle
+ */
+struct Job
+{
+    std::function<void()> function{};
+    std::atomic<size_t> pending_dependencies{1}; // Dependencies not finished yet, plus one while the job is being scheduled
+    std::atomic<bool> finished{false};
+    std::mutex mutex{};
+    std::vector<std::shared_ptr<Job>> continuations{}; // Jobs waiting for this one
+};
+
+using JobHandle = std::shared_ptr<Job>;
+
+/**
+ * @brief Work-stealing job system, owned by the GameEngine.
+ *
+ * A fixed number of worker threads is created once. Each worker has its own queue:
+ * it pushes and pops jobs at the back of its queue, and steals jobs at the front of the other queues when its own is empty.
+ * Threads that are not workers (main thread) push to a shared queue, that the workers steal from too.
+ *
+ * A job can depend on other jobs, it is only queued once all its dependencies are finished.
+ *
+ * Usage:
+ *
+ * - schedule(function, dependencies): Queue a job, after the given jobs if any
+ *
+ * - then(job, function): Queue a continuation, it runs once the job is finished
+ *
+ * - wait(job): Wait for the job, the waiting thread executes other jobs meanwhile
+ *
+ * - parallel_for(count, grain, function): Split [0, count) in chunks of grain indices and execute function(begin, end)
+ *   on each chunk, the calling thread works too and returns once every chunk is done
+ *
+ * @note Waiting from a job is allowed, the thread keeps executing jobs instead of blocking
+ * @note Non copyable, non movable
+ */
+class JobSystem
+{
+public:
+    /**
+     * @brief Create a job system using one worker per hardware thread, minus the main thread
+     */
+    explicit JobSystem();
+
+    /**
+     * @brief Create a job system with the given number of workers
+     *
+     * @param worker_count Number of workers, with 0 jobs only run on threads that wait for them
+     */
+    explicit JobSystem(size_t worker_count);
+
+    /**
+     * @brief Stop the workers once the queued jobs are done
+     */
+    ~JobSystem();
+
+    /* Delete copy and move */
+    JobSystem(const JobSystem &) noexcept = delete;
+    JobSystem &operator=(const JobSystem &) noexcept = delete;
+    JobSystem(JobSystem &&) noexcept = delete;
+    JobSystem &operator=(JobSystem &&) noexcept = delete;
+
+    /**
+     * @brief Queue a job
+     *
+     * @param function Function executed by the job
+     */
+    JobHandle schedule(std::function<void()> function);
+
+    /**
+     * @brief Queue a job that runs once all the given jobs are finished
+     *
+     * @param function Function executed by the job
+     * @param dependencies Jobs that must be finished first
+     */
+    JobHandle schedule(std::function<void()> function, const std::vector<JobHandle> &dependencies);
+
+    /**
+     * @brief Queue a job that runs once the given job is finished
+     *
+     * @param job Job to continue
+     * @param function Function executed by the continuation
+     */
+    JobHandle then(const JobHandle &job, std::function<void()> function);
+
+    /**
+     * @brief Wait until the job is finished, execute other jobs meanwhile
+     *
+     * @param job Job to wait for
+     */
+    void wait(const JobHandle &job);
+
+    /**
+     * @brief Execute function(begin, end) over [0, count), split in chunks of grain indices
+     *
+     * @param count Number of indices
+     * @param grain Number of indices per chunk, ranges smaller than this run on the calling thread
+     * @param function Function called with each chunk
+     */
+    template <typename F>
+    void parallel_for(size_t count, size_t grain, F &&function);
+
+    /**
+     * @brief Return the number of worker threads
+     */
+    [[nodiscard]]
+    size_t size() const noexcept;
+
+private:
+    /**
+     * @brief Queue of jobs, one per worker plus one for the other threads
+     */
+    struct Queue
+    {
+        std::deque<JobHandle> jobs{};
+        std::mutex mutex{};
+    };
+
+    /**
+     * @brief Progress of a parallel_for, shared with the jobs helping on it
+     */
+    struct ParallelForState
+    {
+        std::atomic<size_t> next_chunk{};
+        std::atomic<size_t> done_chunks{};
+        size_t chunk_count{};
+    };
+
+    /**
+     * @brief Loop of a worker thread
+     *
+     * @param index Worker's index, also index of its queue
+     */
+    void worker_loop(size_t index);
+
+    /**
+     * @brief Add a job whose dependencies are finished to the queue of the calling thread
+     *
+     * @param job Job ready to run
+     */
+    void push(JobHandle job);
+
+    /**
+     * @brief Take a job from the queue of the calling thread, or steal one from another queue
+     *
+     * @return The job, or nullptr if every queue is empty
+     */
+    [[nodiscard]]
+    JobHandle pop();
+
+    /**
+     * @brief Execute the job and queue the continuations that were only waiting for it
+     *
+     * @param job Job to execute
+     */
+    void execute(const JobHandle &job);
+
+    /**
+     * @brief Execute one queued job on the calling thread
+     *
+     * @return False if there was no queued job
+     */
+    bool run_one();
+
+    /**
+     * @brief Return the index of the queue used by the calling thread
+     */
+    [[nodiscard]]
+    size_t queue_index() const noexcept;
+
+private:
+    /* Worker index of the calling thread, in the job system that owns it */
+    static thread_local const JobSystem *t_owner;
+    static thread_local size_t t_worker;
+
+    std::vector<std::unique_ptr<Queue>> m_queues{};
+    std::vector<std::thread> m_workers{};
+    std::atomic<size_t> m_queued{};
+    std::mutex m_sleep_mutex{};
+    std::condition_variable m_wake{};
+    bool m_stop{false};
+};
+
+/* TEMPLATE FUNCTIONS HERE */
+
+template <typename F>
+void JobSystem::parallel_for(size_t count, size_t grain, F &&function)
+{
+    grain = std::max<size_t>(grain, 1);
+    if (count <= grain || m_workers.empty())
+    {
+        if (count > 0)
+        {
+            function(size_t{0}, count);
+        }
+        return;
+    }
+
+    auto state{std::make_shared<ParallelForState>()};
+    state->chunk_count = (count + grain - 1) / grain;
+
+    /* Claim chunks until there is none left, the state is shared so late helpers do not outlive it */
+    auto work{[state, count, grain, &function]()
+              {
+                  for (size_t chunk = state->next_chunk++; chunk < state->chunk_count; chunk = state->next_chunk++)
+                  {
+                      const size_t begin{chunk * grain};
+                      function(begin, std::min(begin + grain, count));
+                      state->done_chunks++;
+                  }
+              }};
+
+    const size_t helpers{std::min(m_workers.size(), state->chunk_count - 1)};
+    for (size_t i = 0; i < helpers; ++i)
+    {
+        schedule(work);
+    }
+    work();
+
+    /* Chunks may still run on workers, execute other jobs while waiting */
+    while (state->done_chunks < state->chunk_count)
+    {
+        if (!run_one())
+        {
+            std::this_thread::yield();
+        }
+    }
+}
@@ -1,49 +1,329 @@
 #pragma once
 
-#include <memory>
 #include <limits>
+#include <algorithm>
+#include <array>
+#include <span>
 #include <SFML/System/Vector2.hpp>
-#include "entity.hpp"
+#include "entity_manager.hpp"
+#include "fixed_point.hpp"
+#include "misc.hpp"
 
 namespace Physics
 {
     /**
-     * @brief Get the current overlap between two entities that have a BoundingBox component.
-     * 
-     * Uses the Axis-Aligned Bounding Box method (AABB).
-     * 
-     * Entities collide iff ox > 0 && oy > 0.
-     * 
-     * Return (ox, oy) if entities collide, else (0, 0).
+     * @brief Number type of the simulation math: movement integration, overlaps, SAT and resolution.
      *
-     * @param a First entity
-     * @param b Second entity
+     * Build with MEGAMARIO_FIXED_POINT to use 48.16 fixed point, each helper below then gives the same bits on any build
+     * for the same inputs.
+     *
+     * @warning This is a partial mode, the simulation is not the same bit for bit across builds. Components keep float
+     * values, converted to Real for one helper and rounded back to float after it. The other physics code stays in float
+     * whatever the mode: the swept time of impact, the float boxes stored in BoxBatch, the scene queries (WorldQuery, TileGrid,
+     * StaticBvh, raycasts) and the gameplay math of the systems (walking speed, jump strength added to the velocity),
+     * so their float rounding still reaches the state.
+     *
+     * - to_real(value) / to_float(value): Convert from and to float
+     *
+     * - max_real(): Largest number
+     *
+     * - real_name: Name of the type, for the debug window
+     */
+#if defined(MEGAMARIO_FIXED_POINT)
+    using Real = Fixed;
+
+    inline constexpr const char *real_name{"48.16 fixed point"};
+
+    [[nodiscard]]
+    constexpr Real to_real(float value) noexcept
+    {
+        return Fixed::from_float(value);
+    }
+
+    [[nodiscard]]
+    constexpr float to_float(Real value) noexcept
+    {
+        return value.to_float();
+    }
+
+    [[nodiscard]]
+    constexpr Real max_real() noexcept
+    {
+        return Fixed::max();
+    }
+#else
+    using Real = float;
+
+    inline constexpr const char *real_name{"float"};
+
+    [[nodiscard]]
+    constexpr Real to_real(float value) noexcept
+    {
+        return value;
+    }
+
+    [[nodiscard]]
+    constexpr float to_float(Real value) noexcept
+    {
+        return value;
+    }
+
+    [[nodiscard]]
+    constexpr Real max_real() noexcept
+    {
+        return std::numeric_limits<float>::max();
+    }
+#endif
+
+    /**
+     * @brief Margin added when the player is pushed out of a tile on x, so stacked tiles do not catch it
+     */
+    inline constexpr float resolution_epsilon{2.0f};
+
+    /**
+     * @brief Absolute value of a simulation number
      */
     [[nodiscard]]
-    inline sf::Vector2f get_current_overlap(const std::shared_ptr<Entity> &a, const std::shared_ptr<Entity> &b) noexcept
+    constexpr Real absolute(Real value) noexcept
     {
-        if (!a->has<CBoundingBox>() || !b->has<CBoundingBox>() || !a->has<CTransform>() || !b->has<CTransform>())
+        return value < Real{} ? -value : value;
+    }
+
+    /**
+     * @brief Overlap of two boxes on each axis, computed in Real, (0, 0) if they do not collide
+     *
+     * @param center_a Center of the first box
+     * @param half_a Half size of the first box
+     * @param center_b Center of the second box
+     * @param half_b Half size of the second box
+     */
+    [[nodiscard]]
+    constexpr sf::Vector2f get_box_overlap(const sf::Vector2f &center_a, const sf::Vector2f &half_a,
+                                           const sf::Vector2f &center_b, const sf::Vector2f &half_b) noexcept
+    {
+        const Real ox{to_real(half_a.x) + to_real(half_b.x) - absolute(to_real(center_a.x) - to_real(center_b.x))};
+        const Real oy{to_real(half_a.y) + to_real(half_b.y) - absolute(to_real(center_a.y) - to_real(center_b.y))};
+        return ox > Real{} && oy > Real{} ? sf::Vector2f{to_float(ox), to_float(oy)} : sf::Vector2f{0.0f, 0.0f};
+    }
+
+    /**
+     * @brief Apply gravity to a velocity, capped to the maximum fall speed, computed in Real
+     *
+     * @param velocity Velocity
+     * @param gravity Gravity added to the y velocity
+     * @param max_speed Maximum y velocity
+     */
+    constexpr void apply_gravity(sf::Vector2f &velocity, float gravity, float max_speed) noexcept
+    {
+        velocity.y = to_float(std::min(to_real(velocity.y) + to_real(gravity), to_real(max_speed)));
+    }
+
+    /**
+     * @brief Move a position by a velocity, computed in Real
+     *
+     * @param position Position
+     * @param velocity Velocity
+     */
+    constexpr void integrate(sf::Vector2f &position, const sf::Vector2f &velocity) noexcept
+    {
+        position = sf::Vector2f{to_float(to_real(position.x) + to_real(velocity.x)), to_float(to_real(position.y) + to_real(velocity.y))};
+    }
+
+    /**
+     * @brief Return a coordinate pushed out of an overlap: position + (overlap + margin) * direction, computed in Real
+     *
+     * @param position Coordinate to move
+     * @param overlap Overlap on this axis
+     * @param margin Added to the overlap
+     * @param direction 1 or -1
+     */
+    [[nodiscard]]
+    constexpr float push_out(float position, float overlap, float margin, float direction) noexcept
+    {
+        return to_float(to_real(position) + (to_real(overlap) + to_real(margin)) * to_real(direction));
+    }
+
+    /**
+     * @brief Axis-aligned bounds in world space
+     */
+    struct Aabb
+    {
+        sf::Vector2f min{};
+        sf::Vector2f max{};
+    };
+
+    /**
+     * @brief Closest collider hit by a ray
+     */
+    struct RayHit
+    {
+        Entity entity{};
+        sf::Vector2f point{};
+        sf::Vector2f normal{}; // Face hit, (0, 0) if the ray starts inside the collider
+        float distance{};
+    };
+
+    /**
+     * @brief Intersect a ray with axis-aligned bounds, using the slab method
+     *
+     * @param origin Start of the ray
+     * @param direction Unit direction of the ray
+     * @param max_distance Length of the ray
+     * @param bounds Bounds to test
+     * @param distance Distance along the ray to the hit, 0 if the origin is inside the bounds
+     * @param normal Face hit, (0, 0) if the origin is inside the bounds
+     *
+     * @return True if the ray hits the bounds before max_distance
+     */
+    [[nodiscard]]
+    inline bool raycast_bounds(const sf::Vector2f &origin, const sf::Vector2f &direction, float max_distance, const Aabb &bounds,
+                               float &distance, sf::Vector2f &normal) noexcept
+    {
+        float entry{0.0f};
+        float exit{max_distance};
+        sf::Vector2f entry_normal{0.0f, 0.0f};
+
+        const std::array<float, 2> origins{origin.x, origin.y};
+        const std::array<float, 2> directions{direction.x, direction.y};
+        const std::array<float, 2> mins{bounds.min.x, bounds.min.y};
+        const std::array<float, 2> maxs{bounds.max.x, bounds.max.y};
+        for (size_t axis = 0; axis < 2; ++axis)
         {
-            return sf::Vector2f{0.0f, 0.0f};
+            if (directions[axis] == 0.0f)
+            {
+                if (origins[axis] < mins[axis] || origins[axis] > maxs[axis])
+                {
+                    return false;
+                }
+                continue;
+            }
+
+            float near{(mins[axis] - origins[axis]) / directions[axis]};
+            float far{(maxs[axis] - origins[axis]) / directions[axis]};
+            if (near > far)
+            {
+                std::swap(near, far);
+            }
+
+            if (near > entry)
+            {
+                entry = near;
+                entry_normal = axis == 0 ? sf::Vector2f{directions[axis] > 0.0f ? -1.0f : 1.0f, 0.0f}
+                                         : sf::Vector2f{0.0f, directions[axis] > 0.0f ? -1.0f : 1.0f};
+            }
+            exit = std::min(exit, far);
+            if (entry > exit)
+            {
+                return false;
+            }
         }
 
-        const auto &a_box_half_size{a->get<CBoundingBox>().half_size};
-        const auto &a_offset{a->get<CBoundingBox>().offset};
-        const auto &a_current_pos{a->get<CTransform>().pos};
-        const auto &b_box_half_size{b->get<CBoundingBox>().half_size};
-        const auto &b_offset{b->get<CBoundingBox>().offset};
-        const auto &b_current_pos{b->get<CTransform>().pos};
+        distance = entry;
+        normal = entry_normal;
+        return true;
+    }
 
-        const auto delta{absolute_vec((a_current_pos + a_offset) - (b_current_pos + b_offset))};
-        const float ox{a_box_half_size.x + b_box_half_size.x - delta.x};
-        const float oy{a_box_half_size.y + b_box_half_size.y - delta.y};
+    /**
+     * @brief Return true if two bounds overlap, bounds that only touch do not
+     *
+     * @param a First bounds
+     * @param b Second bounds
+     */
+    [[nodiscard]]
+    constexpr bool overlaps(const Aabb &a, const Aabb &b) noexcept
+    {
+        return a.min.x < b.max.x && b.min.x < a.max.x && a.min.y < b.max.y && b.min.y < a.max.y;
+    }
 
+    /**
+     * @brief Return true if two collision filters accept each other, to call before any overlap test
+     *
+     * @param a First filter
+     * @param b Second filter
+     */
+    [[nodiscard]]
+    constexpr bool can_collide(const CCollisionFilter &a, const CCollisionFilter &b) noexcept
+    {
+        return (a.layer & b.mask) != 0 && (b.layer & a.mask) != 0;
+    }
 
-        return (ox > 0.0f && oy > 0.0f) ? sf::Vector2f{ox, oy} : sf::Vector2f{0.0f, 0.0f};
+    /**
+     * @brief Return the collision filter of an entity, a filter that accepts every layer if it has none
+     *
+     * @param entity Entity
+     */
+    [[nodiscard]]
+    inline CCollisionFilter get_collision_filter(const Entity &entity) noexcept
+    {
+        return entity.has<CCollisionFilter>() ? entity.get<CCollisionFilter>() : CCollisionFilter{};
     }
 
     /**
-     * @brief Get the previous overlap between two entities that have a BoundingBox component.
+     * @brief Get the world bounds of an entity's collider.
+     *
+     * Uses the BoundingBox if the entity has one, else the points of its BoundingConvex.
+     *
+     * Return empty bounds at the origin if the entity has no collider.
+     *
+     * @param entity Entity
+     */
+    [[nodiscard]]
+    inline Aabb get_bounds(const Entity &entity) noexcept
+    {
+        if (!entity.has<CTransform>())
+        {
+            return Aabb{};
+        }
+
+        const auto &pos{entity.get<CTransform>().pos};
+        if (entity.has<CBoundingBox>())
+        {
+            const auto &box{entity.get<CBoundingBox>()};
+            return Aabb{pos + box.offset - box.half_size, pos + box.offset + box.half_size};
+        }
+
+        if (entity.has<CBoundingConvex>())
+        {
+            const auto &convex{entity.get<CBoundingConvex>()};
+            Aabb bounds{sf::Vector2f{std::numeric_limits<float>::max(), std::numeric_limits<float>::max()},
+                        sf::Vector2f{std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()}};
+            for (size_t i = 0; i < convex.count; ++i)
+            {
+                const sf::Vector2f point{convex.points[i] * convex.scale + pos};
+                bounds.min = sf::Vector2f{std::min(bounds.min.x, point.x), std::min(bounds.min.y, point.y)};
+                bounds.max = sf::Vector2f{std::max(bounds.max.x, point.x), std::max(bounds.max.y, point.y)};
+            }
+            return bounds;
+        }
+        return Aabb{};
+    }
+
+    /**
+     * @brief Get the world bounds covered by an entity's collider during the frame.
+     *
+     * For a swept BoundingBox, the bounds at previous_pos and at pos are merged, else same as get_bounds.
+     *
+     * @param entity Entity
+     */
+    [[nodiscard]]
+    inline Aabb get_swept_bounds(const Entity &entity) noexcept
+    {
+        const auto bounds{get_bounds(entity)};
+        if (!entity.has<CTransform>() || !entity.has<CBoundingBox>() || !entity.get<CBoundingBox>().swept)
+        {
+            return bounds;
+        }
+
+        const auto &transform{entity.get<CTransform>()};
+        const sf::Vector2f motion{transform.previous_pos - transform.pos};
+        return Aabb{sf::Vector2f{std::min(bounds.min.x, bounds.min.x + motion.x), std::min(bounds.min.y, bounds.min.y + motion.y)},
+                    sf::Vector2f{std::max(bounds.max.x, bounds.max.x + motion.x), std::max(bounds.max.y, bounds.max.y + motion.y)}};
+    }
+
+    /**
+     * @brief Get the current overlap between two entities that have a BoundingBox component.
+     * 
+     * Uses the Axis-Aligned Bounding Box method (AABB).
      * 
      * Entities collide iff ox > 0 && oy > 0.
      * 
@@ -53,32 +333,26 @@ namespace Physics
      * @param b Second entity
      */
     [[nodiscard]]
-    inline sf::Vector2f get_previous_overlap(const std::shared_ptr<Entity> &a, const std::shared_ptr<Entity> &b) noexcept
+    inline sf::Vector2f get_current_overlap(const Entity &a, const Entity &b) noexcept
     {
-        if (!a->has<CBoundingBox>() || !b->has<CBoundingBox>() || !a->has<CTransform>() || !b->has<CTransform>())
+        if (!a.has<CBoundingBox>() || !b.has<CBoundingBox>() || !a.has<CTransform>() || !b.has<CTransform>())
         {
             return sf::Vector2f{0.0f, 0.0f};
         }
 
-        const auto &a_box_half_size{a->get<CBoundingBox>().half_size};
-        const auto &a_offset{a->get<CBoundingBox>().offset};
-        const auto &a_previous_pos{a->get<CTransform>().previous_pos};
-        const auto &b_box_half_size{b->get<CBoundingBox>().half_size};
-        const auto &b_offset{b->get<CBoundingBox>().offset};
-        const auto &b_previous_pos{b->get<CTransform>().previous_pos};
-
-        const auto delta{absolute_vec((a_previous_pos + a_offset) - (b_previous_pos + b_offset))};
-        const float ox{a_box_half_size.x + b_box_half_size.x - delta.x};
-        const float oy{a_box_half_size.y + b_box_half_size.y - delta.y};
+        const auto &a_box_half_size{a.get<CBoundingBox>().half_size};
+        const auto &a_offset{a.get<CBoundingBox>().offset};
+        const auto &a_current_pos{a.get<CTransform>().pos};
+        const auto &b_box_half_size{b.get<CBoundingBox>().half_size};
+        const auto &b_offset{b.get<CBoundingBox>().offset};
+        const auto &b_current_pos{b.get<CTransform>().pos};
 
-        return ox > 0.0f && oy > 0.0f ? sf::Vector2f{ox, oy} : sf::Vector2f{0.0f, 0.0f};
+        return get_box_overlap(a_current_pos + a_offset, a_box_half_size, b_current_pos + b_offset, b_box_half_size);
     }
 
     /**
-     * @brief Get the current overlap between two entities that have a BoundingConvex component.
+     * @brief Get the previous overlap between two entities that have a BoundingBox component.
      * 
-     * Uses the Separated-Axis-Theorem (SAT).
-     *
      * Entities collide iff ox > 0 && oy > 0.
      * 
      * Return (ox, oy) if entities collide, else (0, 0).
@@ -87,71 +361,94 @@ namespace Physics
      * @param b Second entity
      */
     [[nodiscard]]
-    inline sf::Vector2f get_convex_current_overlap(const std::shared_ptr<Entity> &a, const std::shared_ptr<Entity> &b) noexcept
+    inline sf::Vector2f get_previous_overlap(const Entity &a, const Entity &b) noexcept
     {
-        if (!a->has<CBoundingConvex>() || !b->has<CBoundingConvex>() || !a->has<CTransform>() || !b->has<CTransform>())
+        if (!a.has<CBoundingBox>() || !b.has<CBoundingBox>() || !a.has<CTransform>() || !b.has<CTransform>())
         {
             return sf::Vector2f{0.0f, 0.0f};
         }
 
-        const auto &convex_a{a->get<CBoundingConvex>()};
-        const auto &convex_b{b->get<CBoundingConvex>()};
-        const auto &transform_a{a->get<CTransform>()};
-        const auto &transform_b{b->get<CTransform>()};
-
-        // Transform points to world space
-        auto get_world_points = [](const CBoundingConvex &convex, const CTransform &transform)
-        {
-            std::vector<sf::Vector2f> world_points;
-            world_points.reserve(convex.count);
-
-            for (const auto &point : convex.points)
-            {
-                // Apply scale then position
-                sf::Vector2f scaled_point{point * convex.scale};
-
-                world_points.emplace_back(scaled_point + transform.pos);
-            }
-            return world_points;
-        };
+        const auto &a_box_half_size{a.get<CBoundingBox>().half_size};
+        const auto &a_offset{a.get<CBoundingBox>().offset};
+        const auto &a_previous_pos{a.get<CTransform>().previous_pos};
+        const auto &b_box_half_size{b.get<CBoundingBox>().half_size};
+        const auto &b_offset{b.get<CBoundingBox>().offset};
+        const auto &b_previous_pos{b.get<CTransform>().previous_pos};
 
-        auto points_a{get_world_points(convex_a, transform_a)};
-        auto points_b{get_world_points(convex_b, transform_b)};
+        return get_box_overlap(a_previous_pos + a_offset, a_box_half_size, b_previous_pos + b_offset, b_box_half_size);
+    }
 
-        // Get all unique normals (perpendicular to edges)
-        auto get_normals = [](const std::vector<sf::Vector2f> &points)
+    /**
+     * @brief Compute the world points of a convex collider that never moves, SAT tests then reuse them.
+     *
+     * @param convex Convex collider
+     * @param transform Its transform
+     */
+    inline void cache_world_points(CBoundingConvex &convex, const CTransform &transform) noexcept
+    {
+        for (size_t i = 0; i < convex.count; ++i)
         {
-            std::vector<sf::Vector2f> normals{};
-            normals.reserve(points.size());
-
-            for (size_t i = 0; i < points.size(); ++i)
-            {
-                size_t next{(i + 1) % points.size()};
+            convex.world_points[i] = convex.points[i] * convex.scale + transform.pos;
+        }
+        convex.world_pos = transform.pos;
+        convex.world_cached = true;
+    }
 
-                // Edge vector
-                sf::Vector2f edge{points[next] - points[i]};
+    /**
+     * @brief Get the world points of a convex collider, from its cache if it is still valid.
+     *
+     * @param convex Convex collider
+     * @param transform Its transform
+     * @param storage Filled with the world points if the cache cannot be used
+     */
+    [[nodiscard]]
+    inline std::span<const sf::Vector2f> get_world_points(const CBoundingConvex &convex, const CTransform &transform,
+                                                          std::array<sf::Vector2f, CBoundingConvex::max_points> &storage) noexcept
+    {
+        if (convex.world_cached && convex.world_pos == transform.pos)
+        {
+            return std::span{convex.world_points.data(), convex.count};
+        }
 
-                // Normal (perpendicular to edge)
-                sf::Vector2f normal{-edge.y, edge.x};
+        for (size_t i = 0; i < convex.count; ++i)
+        {
+            storage[i] = convex.points[i] * convex.scale + transform.pos;
+        }
+        return std::span{storage.data(), convex.count};
+    }
 
-                // Normalize
-                if (normal.lengthSquared() > 0.0f)
-                {
-                    normals.push_back(normal.normalized());
-                }
-            }
-            return normals;
-        };
+    /**
+     * @brief Get the overlap between two convex polygons given in world space.
+     *
+     * Uses the Separated-Axis-Theorem (SAT), the axes are the given unit normals, zero normals are skipped.
+     *
+     * Return the overlap along the axis of minimum penetration, pointing from a to b, or (0, 0) if shapes do not collide.
+     *
+     * @param points_a Points of the first polygon
+     * @param normals_a Edge normals of the first polygon
+     * @param points_b Points of the second polygon
+     * @param normals_b Edge normals of the second polygon
+     */
+    [[nodiscard]]
+    inline sf::Vector2f get_polygon_overlap(std::span<const sf::Vector2f> points_a, std::span<const sf::Vector2f> normals_a,
+                                            std::span<const sf::Vector2f> points_b, std::span<const sf::Vector2f> normals_b) noexcept
+    {
+        if (points_a.empty() || points_b.empty())
+        {
+            return sf::Vector2f{0.0f, 0.0f};
+        }
 
         // Project polygon onto axis
-        auto project = [](const std::vector<sf::Vector2f> &points, const sf::Vector2f &axis)
+        auto project = [](std::span<const sf::Vector2f> points, const sf::Vector2f &axis)
         {
-            float min_proj{points[0].dot(axis)};
-            float max_proj{min_proj};
+            const Real axis_x{to_real(axis.x)};
+            const Real axis_y{to_real(axis.y)};
+            Real min_proj{to_real(points[0].x) * axis_x + to_real(points[0].y) * axis_y};
+            Real max_proj{min_proj};
 
             for (size_t i = 1; i < points.size(); ++i)
             {
-                float proj{points[i].dot(axis)};
+                Real proj{to_real(points[i].x) * axis_x + to_real(points[i].y) * axis_y};
                 min_proj = std::min(min_proj, proj);
                 max_proj = std::max(max_proj, proj);
             }
@@ -159,18 +456,19 @@ namespace Physics
             return std::make_pair(min_proj, max_proj);
         };
 
-        // Get all axes to test
-        auto normals_a{get_normals(points_a)};
-        auto normals_b{get_normals(points_b)};
-
-        float min_overlap{std::numeric_limits<float>::max()};
+        Real min_overlap{max_real()};
         sf::Vector2f collision_axis{0.0f, 0.0f};
 
         // Test all axes
-        auto test_axes = [&](const std::vector<sf::Vector2f> &axes)
+        auto test_axes = [&](std::span<const sf::Vector2f> axes)
         {
             for (const auto &axis : axes)
             {
+                if (axis.x == 0.0f && axis.y == 0.0f)
+                {
+                    continue; // Empty edge
+                }
+
                 auto [min_a, max_a]{project(points_a, axis)};
                 auto [min_b, max_b]{project(points_b, axis)};
 
@@ -181,7 +479,7 @@ namespace Physics
                 }
 
                 // Calculate overlap
-                float overlap{std::min(max_a - min_b, max_b - min_a)};
+                Real overlap{std::min(max_a - min_b, max_b - min_a)};
 
                 if (overlap < min_overlap)
                 {
@@ -199,60 +497,118 @@ namespace Physics
         }
 
         // Ensure the collision axis points from A to B
-        sf::Vector2f center_a{0.0f, 0.0f};
-        sf::Vector2f center_b{0.0f, 0.0f};
-
-        for (const auto &point : points_a)
-        {
-            center_a += point;
-        }
-        center_a /= static_cast<float>(points_a.size());
-
-        for (const auto &point : points_b)
+        auto get_center = [](std::span<const sf::Vector2f> points)
         {
-            center_b += point;
-        }
-        center_b /= static_cast<float>(points_b.size());
+            Real x{};
+            Real y{};
+            for (const auto &point : points)
+            {
+                x += to_real(point.x);
+                y += to_real(point.y);
+            }
+            const Real count{to_real(static_cast<float>(points.size()))};
+            return std::make_pair(x / count, y / count);
+        };
 
-        sf::Vector2f center_diff{center_b - center_a};
+        const auto [center_a_x, center_a_y]{get_center(points_a)};
+        const auto [center_b_x, center_b_y]{get_center(points_b)};
 
         // If collision axis points in opposite direction, flip it
-        float dot{collision_axis.dot(center_diff)};
-        if (dot < 0.0f)
+        Real axis_x{to_real(collision_axis.x)};
+        Real axis_y{to_real(collision_axis.y)};
+        Real dot{axis_x * (center_b_x - center_a_x) + axis_y * (center_b_y - center_a_y)};
+        if (dot < Real{})
         {
-            collision_axis.x = -collision_axis.x;
-            collision_axis.y = -collision_axis.y;
+            axis_x = -axis_x;
+            axis_y = -axis_y;
         }
 
         // Return overlap vector
         return {
-            collision_axis.x * min_overlap,
-            collision_axis.y * min_overlap};
+            to_float(axis_x * min_overlap),
+            to_float(axis_y * min_overlap)};
     }
 
     /**
-     * @brief Get the current overlap between two entities, one has a BoundingConvex component, the other has a BoundingBox component.
+     * @brief Get the current overlap between two convex shapes.
+     *
+     * Uses the Separated-Axis-Theorem (SAT), on fixed-capacity arrays: nothing is allocated.
      *
+     * Return the overlap along the axis of minimum penetration, pointing from a to b, or (0, 0) if shapes do not collide.
+     *
+     * @param convex_a First shape
+     * @param transform_a Transform of the first shape
+     * @param convex_b Second shape
+     * @param transform_b Transform of the second shape
+     */
+    [[nodiscard]]
+    inline sf::Vector2f get_convex_current_overlap(const CBoundingConvex &convex_a, const CTransform &transform_a,
+                                                   const CBoundingConvex &convex_b, const CTransform &transform_b) noexcept
+    {
+        std::array<sf::Vector2f, CBoundingConvex::max_points> storage_a;
+        std::array<sf::Vector2f, CBoundingConvex::max_points> storage_b;
+
+        return get_polygon_overlap(get_world_points(convex_a, transform_a, storage_a), std::span{convex_a.normals.data(), convex_a.count},
+                                   get_world_points(convex_b, transform_b, storage_b), std::span{convex_b.normals.data(), convex_b.count});
+    }
+
+    /**
+     * @brief Get the current overlap between two entities that have a BoundingConvex component.
+     * 
      * Uses the Separated-Axis-Theorem (SAT).
      *
      * Entities collide iff ox > 0 && oy > 0.
      * 
      * Return (ox, oy) if entities collide, else (0, 0).
      *
+     * @param a First entity
+     * @param b Second entity
+     */
+    [[nodiscard]]
+    inline sf::Vector2f get_convex_current_overlap(const Entity &a, const Entity &b) noexcept
+    {
+        if (!a.has<CBoundingConvex>() || !b.has<CBoundingConvex>() || !a.has<CTransform>() || !b.has<CTransform>())
+        {
+            return sf::Vector2f{0.0f, 0.0f};
+        }
+
+        return get_convex_current_overlap(a.get<CBoundingConvex>(), a.get<CTransform>(), b.get<CBoundingConvex>(), b.get<CTransform>());
+    }
+
+    /**
+     * @brief Get the current overlap between two entities, one has a BoundingConvex component, the other has a BoundingBox component.
+     *
+     * Uses the Separated-Axis-Theorem (SAT), on stack arrays: nothing is allocated and the entities are not modified.
+     *
+     * Entities collide iff ox > 0 && oy > 0.
+     * 
+     * Return (ox, oy) if entities collide, else (0, 0).
+     *
      * @param a First entity with the BoundingConvex component
      * @param b Second entity with the BoundingBox component
      */
     [[nodiscard]]
-    inline sf::Vector2f get_current_overlap_between_convex_and_box(const std::shared_ptr<Entity> &a, const std::shared_ptr<Entity> &b) noexcept
+    inline sf::Vector2f get_current_overlap_between_convex_and_box(const Entity &a, const Entity &b) noexcept
     {
-        /* Convert the box to a BoundingConvex component and remove it after computation */
-        static const std::vector<sf::Vector2f> box_local{
-            {sf::Vector2f{-0.5f, -0.5f}, sf::Vector2f{-0.5f, 0.5f}, sf::Vector2f{0.5f, 0.5f}, sf::Vector2f{0.5f, -0.5f}}};
-
-        b->add<CBoundingConvex>(box_local, b->get<CBoundingBox>().size);
-        auto result{get_convex_current_overlap(a, b)};
-        b->remove<CBoundingConvex>();
-        return result;
+        if (!a.has<CBoundingConvex>() || !b.has<CBoundingBox>() || !a.has<CTransform>() || !b.has<CTransform>())
+        {
+            return sf::Vector2f{0.0f, 0.0f};
+        }
+
+        /* The box is a polygon of 4 points, its 4 edge normals are only 2 different axes */
+        static constexpr std::array<sf::Vector2f, 2> box_normals{{sf::Vector2f{-1.0f, 0.0f}, sf::Vector2f{0.0f, 1.0f}}};
+
+        const auto &box{b.get<CBoundingBox>()};
+        const sf::Vector2f center{b.get<CTransform>().pos};
+        const std::array<sf::Vector2f, 4> box_points{{center + sf::Vector2f{-box.half_size.x, -box.half_size.y},
+                                                      center + sf::Vector2f{-box.half_size.x, box.half_size.y},
+                                                      center + sf::Vector2f{box.half_size.x, box.half_size.y},
+                                                      center + sf::Vector2f{box.half_size.x, -box.half_size.y}}};
+
+        const auto &convex{a.get<CBoundingConvex>()};
+        std::array<sf::Vector2f, CBoundingConvex::max_points> storage;
+        return get_polygon_overlap(get_world_points(convex, a.get<CTransform>(), storage), std::span{convex.normals.data(), convex.count},
+                                   box_points, box_normals);
     }
 
 };
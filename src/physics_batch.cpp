@@ -0,0 +1,288 @@
+#include "physics_batch.hpp"
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+/* The float kernels are skipped in fixed point, the scalar loop computes every overlap in Real */
+#if !defined(MEGAMARIO_FIXED_POINT) && (defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64))
+#define MEGAMARIO_SIMD_KERNELS
+#include <immintrin.h>
+#endif
+
+////////////////////////////////////////// HELPER FUNCTIONS //////////////////////////////////////////
+
+/**
+ * @brief Overlap of two boxes on each axis, (0, 0) if they do not collide
+ */
+[[nodiscard]]
+static sf::Vector2f box_overlap(float ax, float ay, float ahx, float ahy, float bx, float by, float bhx, float bhy) noexcept
+{
+    return Physics::get_box_overlap(sf::Vector2f{ax, ay}, sf::Vector2f{ahx, ahy}, sf::Vector2f{bx, by}, sf::Vector2f{bhx, bhy});
+}
+
+/**
+ * @brief Add the hit of the candidate i, its previous overlap is computed here since hits are rare
+ */
+static void push_hit(const Physics::QueryBox &query, const Physics::BoxBatch &candidates, uint32_t i, float ox, float oy,
+                     std::vector<Physics::BoxHit> &hits)
+{
+    const sf::Vector2f previous{box_overlap(query.previous_center.x, query.previous_center.y, query.half_size.x, query.half_size.y,
+                                            candidates.previous_x[i], candidates.previous_y[i], candidates.half_x[i], candidates.half_y[i])};
+    hits.push_back(Physics::BoxHit{i, sf::Vector2f{ox, oy}, previous});
+}
+
+/**
+ * @brief Times when a point moving by motion from start enters and leaves the slab [-extent, extent] of one axis
+ *
+ * @return False if the point never is strictly inside the slab
+ */
+[[nodiscard]]
+static bool clip_slab(float start, float motion, float extent, float &entry, float &exit) noexcept
+{
+    if (motion == 0.0f)
+    {
+        entry = -std::numeric_limits<float>::infinity();
+        exit = std::numeric_limits<float>::infinity();
+        return std::abs(start) < extent;
+    }
+
+    const float t1{(-extent - start) / motion};
+    const float t2{(extent - start) / motion};
+    entry = std::min(t1, t2);
+    exit = std::max(t1, t2);
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Physics::BoxBatch::clear() noexcept
+{
+    center_x.clear();
+    center_y.clear();
+    half_x.clear();
+    half_y.clear();
+    previous_x.clear();
+    previous_y.clear();
+    entities.clear();
+}
+
+void Physics::BoxBatch::push(const Entity &entity)
+{
+    if (!entity.has<CBoundingBox>() || !entity.has<CTransform>())
+    {
+        return;
+    }
+
+    const auto &box{entity.get<CBoundingBox>()};
+    const auto &transform{entity.get<CTransform>()};
+    center_x.push_back(transform.pos.x + box.offset.x);
+    center_y.push_back(transform.pos.y + box.offset.y);
+    half_x.push_back(box.half_size.x);
+    half_y.push_back(box.half_size.y);
+    previous_x.push_back(transform.previous_pos.x + box.offset.x);
+    previous_y.push_back(transform.previous_pos.y + box.offset.y);
+    entities.push_back(entity);
+}
+
+void Physics::BoxBatch::push(const Aabb &bounds, const Entity &entity)
+{
+    const sf::Vector2f center{0.5f * (bounds.min + bounds.max)};
+    const sf::Vector2f half_size{0.5f * (bounds.max - bounds.min)};
+    center_x.push_back(center.x);
+    center_y.push_back(center.y);
+    half_x.push_back(half_size.x);
+    half_y.push_back(half_size.y);
+    previous_x.push_back(center.x);
+    previous_y.push_back(center.y);
+    entities.push_back(entity);
+}
+
+[[nodiscard]] size_t Physics::BoxBatch::size() const noexcept
+{
+    return entities.size();
+}
+
+[[nodiscard]] Physics::QueryBox Physics::make_query_box(const Entity &entity) noexcept
+{
+    const auto &box{entity.get<CBoundingBox>()};
+    const auto &transform{entity.get<CTransform>()};
+    return QueryBox{transform.pos + box.offset, transform.previous_pos + box.offset, box.half_size};
+}
+
+[[nodiscard]] sf::Vector2f Physics::get_current_overlap(const QueryBox &query, const BoxBatch &candidates, uint32_t index) noexcept
+{
+    return box_overlap(query.center.x, query.center.y, query.half_size.x, query.half_size.y,
+                       candidates.center_x[index], candidates.center_y[index], candidates.half_x[index], candidates.half_y[index]);
+}
+
+[[nodiscard]] sf::Vector2f Physics::get_overlap_center(const QueryBox &query, const BoxBatch &candidates, uint32_t index) noexcept
+{
+    const float min_x{std::max(query.center.x - query.half_size.x, candidates.center_x[index] - candidates.half_x[index])};
+    const float max_x{std::min(query.center.x + query.half_size.x, candidates.center_x[index] + candidates.half_x[index])};
+    const float min_y{std::max(query.center.y - query.half_size.y, candidates.center_y[index] - candidates.half_y[index])};
+    const float max_y{std::min(query.center.y + query.half_size.y, candidates.center_y[index] + candidates.half_y[index])};
+    return sf::Vector2f{0.5f * (min_x + max_x), 0.5f * (min_y + max_y)};
+}
+
+[[nodiscard]] sf::Vector2f Physics::get_overlap_normal(const QueryBox &query, const BoxBatch &candidates, uint32_t index,
+                                                       const sf::Vector2f &overlap) noexcept
+{
+    if (overlap.x < overlap.y)
+    {
+        return sf::Vector2f{query.center.x >= candidates.center_x[index] ? 1.0f : -1.0f, 0.0f};
+    }
+    return sf::Vector2f{0.0f, query.center.y >= candidates.center_y[index] ? 1.0f : -1.0f};
+}
+
+void Physics::get_current_overlaps(const QueryBox &query, const BoxBatch &candidates, std::vector<BoxHit> &hits)
+{
+    hits.clear();
+    const size_t count{candidates.size()};
+    size_t i{0};
+
+#if defined(MEGAMARIO_SIMD_KERNELS) && defined(__AVX2__)
+    {
+        /* Clearing the sign bit is the absolute value */
+        const __m256 abs_mask{_mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff))};
+        const __m256 zero{_mm256_setzero_ps()};
+        const __m256 qx{_mm256_set1_ps(query.center.x)};
+        const __m256 qy{_mm256_set1_ps(query.center.y)};
+        const __m256 qhx{_mm256_set1_ps(query.half_size.x)};
+        const __m256 qhy{_mm256_set1_ps(query.half_size.y)};
+        alignas(32) float ox[8]{};
+        alignas(32) float oy[8]{};
+
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 dx{_mm256_and_ps(_mm256_sub_ps(qx, _mm256_loadu_ps(&candidates.center_x[i])), abs_mask)};
+            const __m256 dy{_mm256_and_ps(_mm256_sub_ps(qy, _mm256_loadu_ps(&candidates.center_y[i])), abs_mask)};
+            const __m256 overlap_x{_mm256_sub_ps(_mm256_add_ps(qhx, _mm256_loadu_ps(&candidates.half_x[i])), dx)};
+            const __m256 overlap_y{_mm256_sub_ps(_mm256_add_ps(qhy, _mm256_loadu_ps(&candidates.half_y[i])), dy)};
+            const __m256 hit{_mm256_and_ps(_mm256_cmp_ps(overlap_x, zero, _CMP_GT_OQ), _mm256_cmp_ps(overlap_y, zero, _CMP_GT_OQ))};
+
+            auto mask{static_cast<unsigned>(_mm256_movemask_ps(hit))};
+            if (mask == 0) [[likely]]
+            {
+                continue;
+            }
+
+            _mm256_store_ps(ox, overlap_x);
+            _mm256_store_ps(oy, overlap_y);
+            for (; mask != 0; mask &= mask - 1)
+            {
+                const auto lane{std::countr_zero(mask)};
+                push_hit(query, candidates, static_cast<uint32_t>(i + lane), ox[lane], oy[lane], hits);
+            }
+        }
+    }
+#endif
+
+#if defined(MEGAMARIO_SIMD_KERNELS)
+    {
+        const __m128 abs_mask{_mm_castsi128_ps(_mm_set1_epi32(0x7fffffff))};
+        const __m128 zero{_mm_setzero_ps()};
+        const __m128 qx{_mm_set1_ps(query.center.x)};
+        const __m128 qy{_mm_set1_ps(query.center.y)};
+        const __m128 qhx{_mm_set1_ps(query.half_size.x)};
+        const __m128 qhy{_mm_set1_ps(query.half_size.y)};
+        alignas(16) float ox[4]{};
+        alignas(16) float oy[4]{};
+
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 dx{_mm_and_ps(_mm_sub_ps(qx, _mm_loadu_ps(&candidates.center_x[i])), abs_mask)};
+            const __m128 dy{_mm_and_ps(_mm_sub_ps(qy, _mm_loadu_ps(&candidates.center_y[i])), abs_mask)};
+            const __m128 overlap_x{_mm_sub_ps(_mm_add_ps(qhx, _mm_loadu_ps(&candidates.half_x[i])), dx)};
+            const __m128 overlap_y{_mm_sub_ps(_mm_add_ps(qhy, _mm_loadu_ps(&candidates.half_y[i])), dy)};
+            const __m128 hit{_mm_and_ps(_mm_cmpgt_ps(overlap_x, zero), _mm_cmpgt_ps(overlap_y, zero))};
+
+            auto mask{static_cast<unsigned>(_mm_movemask_ps(hit))};
+            if (mask == 0) [[likely]]
+            {
+                continue;
+            }
+
+            _mm_store_ps(ox, overlap_x);
+            _mm_store_ps(oy, overlap_y);
+            for (; mask != 0; mask &= mask - 1)
+            {
+                const auto lane{std::countr_zero(mask)};
+                push_hit(query, candidates, static_cast<uint32_t>(i + lane), ox[lane], oy[lane], hits);
+            }
+        }
+    }
+#endif
+
+    /* Remaining boxes, or every box without SIMD */
+    for (; i < count; ++i)
+    {
+        const sf::Vector2f overlap{box_overlap(query.center.x, query.center.y, query.half_size.x, query.half_size.y,
+                                               candidates.center_x[i], candidates.center_y[i], candidates.half_x[i], candidates.half_y[i])};
+        if (overlap.x > 0.0f && overlap.y > 0.0f)
+        {
+            push_hit(query, candidates, static_cast<uint32_t>(i), overlap.x, overlap.y, hits);
+        }
+    }
+}
+
+[[nodiscard]] bool Physics::get_first_sweep_hit(const QueryBox &query, const BoxBatch &candidates, SweepHit &hit) noexcept
+{
+    bool found{false};
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        /* Move in the frame of the candidate, which may move too */
+        const float start_x{query.previous_center.x - candidates.previous_x[i]};
+        const float start_y{query.previous_center.y - candidates.previous_y[i]};
+        const float motion_x{(query.center.x - query.previous_center.x) - (candidates.center_x[i] - candidates.previous_x[i])};
+        const float motion_y{(query.center.y - query.previous_center.y) - (candidates.center_y[i] - candidates.previous_y[i])};
+
+        float entry_x{}, exit_x{}, entry_y{}, exit_y{};
+        if (!clip_slab(start_x, motion_x, query.half_size.x + candidates.half_x[i], entry_x, exit_x) ||
+            !clip_slab(start_y, motion_y, query.half_size.y + candidates.half_y[i], entry_y, exit_y))
+        {
+            continue;
+        }
+
+        const float entry{std::max(entry_x, entry_y)};
+        const float exit{std::min(exit_x, exit_y)};
+        if (entry >= exit || entry >= 1.0f || exit <= 0.0f)
+        {
+            continue;
+        }
+
+        const float time{std::max(entry, 0.0f)};
+        if (found && time >= hit.time)
+        {
+            continue;
+        }
+
+        /* The last axis entered is the face hit, there is no face if the boxes overlapped from the start */
+        sf::Vector2f normal{0.0f, 0.0f};
+        if (entry >= 0.0f)
+        {
+            normal = (entry_x > entry_y) ? sf::Vector2f{motion_x > 0.0f ? -1.0f : 1.0f, 0.0f}
+                                         : sf::Vector2f{0.0f, motion_y > 0.0f ? -1.0f : 1.0f};
+        }
+        hit = SweepHit{static_cast<uint32_t>(i), time, normal};
+        found = true;
+    }
+    return found;
+}
+
+[[nodiscard]] sf::Vector2f Physics::get_sweep_contact(const QueryBox &query, const BoxBatch &candidates, const SweepHit &hit) noexcept
+{
+    /* Query and candidate centers at the time of impact */
+    const uint32_t i{hit.index};
+    const sf::Vector2f query_center{query.previous_center + (query.center - query.previous_center) * hit.time};
+    const sf::Vector2f candidate_center{sf::Vector2f{candidates.previous_x[i], candidates.previous_y[i]} +
+                                        sf::Vector2f{candidates.center_x[i] - candidates.previous_x[i],
+                                                     candidates.center_y[i] - candidates.previous_y[i]} * hit.time};
+
+    /* Closest point of the candidate to the query center, kept half a pixel inside so it is not on a cell border */
+    static constexpr float inset{0.5f};
+    const float reach_x{std::max(candidates.half_x[i] - inset, 0.0f)};
+    const float reach_y{std::max(candidates.half_y[i] - inset, 0.0f)};
+    return sf::Vector2f{std::clamp(query_center.x, candidate_center.x - reach_x, candidate_center.x + reach_x),
+                        std::clamp(query_center.y, candidate_center.y - reach_y, candidate_center.y + reach_y)};
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <SFML/System/Vector2.hpp>
+#include "physics.hpp"
+
+namespace Physics
+{
+    /**
+     * @brief Candidate boxes packed as a structure of arrays, so the overlap kernel loads 4 or 8 boxes at once.
+     *
+     * Centers include the box offset. Previous centers are only read for the boxes that are hit.
+     *
+     * Usage:
+     *
+     * - clear(): Empty the batch, the arrays keep their memory
+     *
+     * - push(entity): Append the box of an entity that has a BoundingBox and a Transform
+     *
+     * - push(bounds, entity): Append a static box that is not a component (merged tiles), entity may be empty
+     */
+    struct BoxBatch
+    {
+        std::vector<float> center_x{};
+        std::vector<float> center_y{};
+        std::vector<float> half_x{};
+        std::vector<float> half_y{};
+        std::vector<float> previous_x{};
+        std::vector<float> previous_y{};
+        EntityVec entities{};
+
+        /**
+         * @brief Remove every box
+         */
+        void clear() noexcept;
+
+        /**
+         * @brief Append the box of an entity, entities without a BoundingBox or a Transform are ignored
+         *
+         * @param entity Entity
+         */
+        void push(const Entity &entity);
+
+        /**
+         * @brief Append a box that does not move
+         *
+         * @param bounds World bounds
+         * @param entity Entity stored with the box, may be empty
+         */
+        void push(const Aabb &bounds, const Entity &entity);
+
+        /**
+         * @brief Return the number of boxes
+         */
+        [[nodiscard]]
+        size_t size() const noexcept;
+    };
+
+    /**
+     * @brief Box tested against a BoxBatch
+     */
+    struct QueryBox
+    {
+        sf::Vector2f center{};
+        sf::Vector2f previous_center{};
+        sf::Vector2f half_size{};
+    };
+
+    /**
+     * @brief Candidate that overlaps the query box
+     */
+    struct BoxHit
+    {
+        uint32_t index{};               // Index of the candidate in the batch
+        sf::Vector2f overlap{};         // Same as get_current_overlap
+        sf::Vector2f previous_overlap{}; // Same as get_previous_overlap
+    };
+
+    /**
+     * @brief First candidate touched by a moving query box
+     */
+    struct SweepHit
+    {
+        uint32_t index{};      // Index of the candidate in the batch
+        float time{};          // Fraction of the motion done at the impact, in [0, 1], 0 if the boxes already overlapped
+        sf::Vector2f normal{}; // Face of the candidate that is hit, pointing to the query box, (0, 0) if the boxes already overlapped
+    };
+
+    /**
+     * @brief Build the query box of an entity, from its BoundingBox and Transform
+     *
+     * @param entity Entity that has a BoundingBox and a Transform
+     */
+    [[nodiscard]]
+    QueryBox make_query_box(const Entity &entity) noexcept;
+
+    /**
+     * @brief Get the current overlap between the query box and one box of a batch.
+     *
+     * Return (ox, oy) if boxes collide, else (0, 0).
+     *
+     * @param query Query box
+     * @param candidates Candidate boxes
+     * @param index Index of the box in the batch
+     */
+    [[nodiscard]]
+    sf::Vector2f get_current_overlap(const QueryBox &query, const BoxBatch &candidates, uint32_t index) noexcept;
+
+    /**
+     * @brief Get the center of the intersection between the query box and one box of a batch.
+     *
+     * @param query Query box
+     * @param candidates Candidate boxes
+     * @param index Index of the box in the batch, it must overlap the query box
+     */
+    [[nodiscard]]
+    sf::Vector2f get_overlap_center(const QueryBox &query, const BoxBatch &candidates, uint32_t index) noexcept;
+
+    /**
+     * @brief Get the normal of the contact between the query box and one box of a batch.
+     *
+     * The axis of the smallest overlap, pointing from the candidate to the query box.
+     *
+     * @param query Query box
+     * @param candidates Candidate boxes
+     * @param index Index of the box in the batch
+     * @param overlap Current overlap of the two boxes
+     */
+    [[nodiscard]]
+    sf::Vector2f get_overlap_normal(const QueryBox &query, const BoxBatch &candidates, uint32_t index, const sf::Vector2f &overlap) noexcept;
+
+    /**
+     * @brief Find the candidates whose box overlaps the query box.
+     *
+     * Uses AVX2 (8 boxes per step) when the build enables it, else SSE2 (4 boxes per step),
+     * and a scalar loop for the remaining boxes or on other architectures.
+     *
+     * @param query Query box
+     * @param candidates Candidate boxes
+     * @param hits Candidates that overlap, cleared first, in batch order
+     */
+    void get_current_overlaps(const QueryBox &query, const BoxBatch &candidates, std::vector<BoxHit> &hits);
+
+    /**
+     * @brief Find the first candidate hit by the query box moving from its previous center to its center.
+     *
+     * Swept AABB test: each candidate is grown by the query half size, and the motion of the query center,
+     * relative to the candidate, is clipped against the slabs of the grown box to get the time of impact.
+     * Boxes that only touch are not hit, same as get_current_overlaps.
+     *
+     * @param query Query box
+     * @param candidates Candidate boxes
+     * @param hit Earliest hit, the lowest index on equal times
+     *
+     * @return True if a candidate is hit during the motion
+     */
+    [[nodiscard]]
+    bool get_first_sweep_hit(const QueryBox &query, const BoxBatch &candidates, SweepHit &hit) noexcept;
+
+    /**
+     * @brief Get a point inside the candidate of a sweep hit, next to where the query box touches it.
+     *
+     * Used to find the tile hit inside a merged rectangle.
+     *
+     * @param query Query box
+     * @param candidates Candidate boxes
+     * @param hit Hit given by get_first_sweep_hit
+     */
+    [[nodiscard]]
+    sf::Vector2f get_sweep_contact(const QueryBox &query, const BoxBatch &candidates, const SweepHit &hit) noexcept;
+};
@@ -0,0 +1,95 @@
+#include "physics_query.hpp"
+#include <cmath>
+#include <algorithm>
+
+Physics::WorldQuery::WorldQuery(const StaticBvh &static_bvh, const SweepAndPrune &sweep) noexcept : m_static_bvh(static_bvh), m_sweep(sweep)
+{
+}
+
+[[nodiscard]] bool Physics::WorldQuery::raycast(const sf::Vector2f &origin, const sf::Vector2f &direction, float max_distance,
+                                                const CCollisionFilter &filter, const Entity &ignore, RayHit &hit)
+{
+    const float length{std::hypot(direction.x, direction.y)};
+    if (length == 0.0f || max_distance < 0.0f)
+    {
+        return false;
+    }
+    const sf::Vector2f unit{direction / length};
+
+    /* The tree gives the closest static collider, the bodies around the ray may be closer */
+    bool found{m_static_bvh.raycast(origin, unit, max_distance, filter, ignore, hit)};
+    const float reach{found ? hit.distance : max_distance};
+
+    const sf::Vector2f end{origin + unit * reach};
+    const Aabb ray_bounds{sf::Vector2f{std::min(origin.x, end.x), std::min(origin.y, end.y)},
+                          sf::Vector2f{std::max(origin.x, end.x), std::max(origin.y, end.y)}};
+
+    /* A ray along an axis has flat bounds, grow them so the overlap test of the sweep accepts the bodies it crosses */
+    static constexpr float epsilon{0.01f};
+    const Aabb query_bounds{ray_bounds.min - sf::Vector2f{epsilon, epsilon}, ray_bounds.max + sf::Vector2f{epsilon, epsilon}};
+
+    m_candidates.clear();
+    m_sweep.query_dynamic(query_bounds, filter, m_candidates);
+    for (const auto &body : m_candidates)
+    {
+        float distance{};
+        sf::Vector2f normal{};
+        if (body == ignore || !raycast_bounds(origin, unit, reach, get_bounds(body), distance, normal))
+        {
+            continue;
+        }
+
+        if (!found || distance < hit.distance)
+        {
+            hit = RayHit{body, origin + unit * distance, normal, distance};
+            found = true;
+        }
+    }
+    return found;
+}
+
+void Physics::WorldQuery::overlap_box(const Aabb &bounds, const CCollisionFilter &filter, const Entity &ignore, EntityVec &out)
+{
+    collect_candidates(bounds, filter, ignore);
+    for (const auto &entity : m_candidates)
+    {
+        if (overlaps(bounds, get_bounds(entity)))
+        {
+            out.push_back(entity);
+        }
+    }
+}
+
+[[nodiscard]] bool Physics::WorldQuery::cast_box(const Aabb &bounds, const sf::Vector2f &motion, const CCollisionFilter &filter,
+                                                 const Entity &ignore, BoxCastHit &hit)
+{
+    const Aabb swept{sf::Vector2f{std::min(bounds.min.x, bounds.min.x + motion.x), std::min(bounds.min.y, bounds.min.y + motion.y)},
+                     sf::Vector2f{std::max(bounds.max.x, bounds.max.x + motion.x), std::max(bounds.max.y, bounds.max.y + motion.y)}};
+    collect_candidates(swept, filter, ignore);
+
+    m_boxes.clear();
+    for (const auto &entity : m_candidates)
+    {
+        m_boxes.push(get_bounds(entity), entity);
+    }
+
+    const sf::Vector2f start{(bounds.min + bounds.max) * 0.5f};
+    const QueryBox query{start + motion, start, (bounds.max - bounds.min) * 0.5f};
+
+    SweepHit sweep_hit{};
+    if (!get_first_sweep_hit(query, m_boxes, sweep_hit))
+    {
+        return false;
+    }
+
+    hit = BoxCastHit{m_boxes.entities[sweep_hit.index], sweep_hit.time, get_sweep_contact(query, m_boxes, sweep_hit), sweep_hit.normal};
+    return true;
+}
+
+void Physics::WorldQuery::collect_candidates(const Aabb &bounds, const CCollisionFilter &filter, const Entity &ignore)
+{
+    m_candidates.clear();
+    m_static_bvh.query(bounds, filter, m_candidates);
+    m_sweep.query_dynamic(bounds, filter, m_candidates);
+    std::erase(m_candidates, ignore);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <SFML/System/Vector2.hpp>
+#include "physics.hpp"
+#include "physics_batch.hpp"
+#include "static_bvh.hpp"
+#include "sweep_and_prune.hpp"
+
+namespace Physics
+{
+    /**
+     * @brief First collider hit by a moving box
+     */
+    struct BoxCastHit
+    {
+        Entity entity{};
+        float time{};          // Fraction of the motion done before the hit, 0 if the box already overlaps the collider
+        sf::Vector2f point{};  // Contact, just inside the collider
+        sf::Vector2f normal{}; // Face hit, pointing from the collider to the box
+    };
+
+    /**
+     * @brief Scene queries over the colliders of the world, answered by the acceleration structures instead of a scan of the entities.
+     *
+     * Static colliders are found through the StaticBvh: a query only visits the nodes whose bounds it touches, closest first for a ray.
+     * Moving bodies are found through the SweepAndPrune, as of its last update.
+     *
+     * The colliders are tested at their current position, with the bounds of their BoundingBox or BoundingConvex.
+     * Every query takes the collision filter of the caller, and an entity to ignore, usually the caller itself.
+     *
+     * Usage:
+     *
+     * - raycast(origin, direction, max_distance, filter, ignore, hit): Closest collider along a ray, for line of sight or camera collision
+     *
+     * - overlap_box(bounds, filter, ignore, out): Colliders overlapping the bounds
+     *
+     * - cast_box(bounds, motion, filter, ignore, hit): First collider hit by the bounds moved by motion, for ground checks
+     *
+     * @note The queries reuse memory kept in the object, one object must not be used by several threads at once
+     */
+    class WorldQuery
+    {
+    public:
+        /**
+         * @brief Create queries over a StaticBvh and a SweepAndPrune, that must outlive this object
+         *
+         * @param static_bvh Static colliders of the level
+         * @param sweep Moving bodies
+         */
+        explicit WorldQuery(const StaticBvh &static_bvh, const SweepAndPrune &sweep) noexcept;
+
+        /**
+         * @brief Find the closest collider hit by a ray
+         *
+         * @param origin Start of the ray
+         * @param direction Direction of the ray, normalized by the query
+         * @param max_distance Length of the ray
+         * @param filter Collision filter of the query
+         * @param ignore Entity never hit, may be empty
+         * @param hit Closest collider hit
+         *
+         * @return True if a collider is hit, false if nothing is hit or the direction is (0, 0)
+         */
+        [[nodiscard]]
+        bool raycast(const sf::Vector2f &origin, const sf::Vector2f &direction, float max_distance, const CCollisionFilter &filter,
+                     const Entity &ignore, RayHit &hit);
+
+        /**
+         * @brief Append the colliders overlapping the bounds, bounds that only touch are not reported
+         *
+         * @param bounds World bounds
+         * @param filter Collision filter of the query
+         * @param ignore Entity never reported, may be empty
+         * @param out Entities
+         */
+        void overlap_box(const Aabb &bounds, const CCollisionFilter &filter, const Entity &ignore, EntityVec &out);
+
+        /**
+         * @brief Find the first collider hit by a box moving in a straight line
+         *
+         * @param bounds World bounds of the box before it moves
+         * @param motion Motion of the box
+         * @param filter Collision filter of the query
+         * @param ignore Entity never hit, may be empty
+         * @param hit First collider hit, the lowest in the candidates order on ties
+         *
+         * @return True if a collider is hit before the end of the motion
+         */
+        [[nodiscard]]
+        bool cast_box(const Aabb &bounds, const sf::Vector2f &motion, const CCollisionFilter &filter, const Entity &ignore,
+                      BoxCastHit &hit);
+
+    private:
+        /**
+         * @brief Fill the candidates with the static colliders and bodies overlapping the bounds
+         */
+        void collect_candidates(const Aabb &bounds, const CCollisionFilter &filter, const Entity &ignore);
+
+    private:
+        const StaticBvh &m_static_bvh;
+        const SweepAndPrune &m_sweep;
+        EntityVec m_candidates{}; // Kept between queries to reuse their memory
+        BoxBatch m_boxes{};
+    };
+}
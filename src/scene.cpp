@@ -18,6 +18,11 @@ void Scene::simulate(unsigned frames)
     }
 }
 
+void Scene::set_interpolation(float alpha) noexcept
+{
+    m_interpolation = alpha;
+}
+
 void Scene::register_action(const Keycode &input_key, const std::string &action_name) noexcept
 {
     m_action_map[input_key] = action_name;
@@ -46,6 +51,11 @@ size_t Scene::get_current_frame() const noexcept
     return m_current_frame;
 }
 
+float Scene::get_interpolation() const noexcept
+{
+    return m_interpolation;
+}
+
 bool Scene::has_ended() const noexcept
 {
     return m_has_ended;
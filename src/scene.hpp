@@ -20,6 +20,9 @@ using ActionMap = std::unordered_map<Keycode, std::string>;
  * 
  * Each scene holds a pointer to the GameEngine to access global data like assets, settings or window properties.
  * 
+ * The GameEngine calls update() once per fixed tick, and render() once per displayed frame, after setting
+ * the fraction of a tick elapsed since the last update, to interpolate positions between ticks.
+ * 
  * The class provides utility functions for:
  * 
  * - Drawing debug lines
@@ -30,12 +33,16 @@ using ActionMap = std::unordered_map<Keycode, std::string>;
  * 
  * Usage: 
  * 
- * - update(): Update the scene logic
+ * - update(): Update the scene logic, one fixed tick
  * 
  * - system_do_action(action): Handle game actions
  * 
+ * - render(): Draw the scene and its GUI, once per frame
+ * 
  * - system_render(): Render the scene
  * 
+ * - set_interpolation(alpha): Fraction of a tick to render between the previous and current positions
+ * 
  * - do_action(): Perform an action
  * 
  * - simulate(frames): Run multiple update frames
@@ -44,7 +51,7 @@ using ActionMap = std::unordered_map<Keycode, std::string>;
  * 
  * @note Each scene has its own EntityManager
  * @note The scene can be paused or ended
- * @note Derived classes must implement update, system_do_action, system_render and on_end.
+ * @note Derived classes must implement update, system_do_action, render, system_render and on_end.
  * 
  */
 class Scene
@@ -62,10 +69,15 @@ public:
     explicit Scene(GameEngine *game) noexcept;
 
     /**
-     * @brief Update the scene
+     * @brief Update the scene by one fixed tick
      */
     virtual void update() = 0;
 
+    /**
+     * @brief Draw the scene and its GUI, once per frame
+     */
+    virtual void render() = 0;
+
     /**
      * @brief Handle an action
      */
@@ -86,6 +98,13 @@ public:
      */
     void simulate(unsigned frames);
 
+    /**
+     * @brief Set the fraction of a tick elapsed since the last update, used by the next render
+     *
+     * @param alpha Fraction in [0, 1], 1 renders the current positions
+     */
+    void set_interpolation(float alpha) noexcept;
+
     /**
      * @brief Register an action
      */
@@ -114,6 +133,12 @@ public:
     [[nodiscard]]
     size_t get_current_frame() const noexcept;
 
+    /**
+     * @brief Return the fraction of a tick to render between the previous and current positions
+     */
+    [[nodiscard]]
+    float get_interpolation() const noexcept;
+
     /**
      * @brief Check if scene has ended
      */
@@ -142,6 +167,7 @@ protected:
     EntityManager m_entities{};
     ActionMap m_action_map{};
     unsigned m_current_frame{};
+    float m_interpolation{1.0f};
     bool m_paused{false};
     bool m_has_ended{false};
 };
@@ -83,6 +83,10 @@ void SceneMenu::update()
 {
     system_sound();
     system_scene();
+}
+
+void SceneMenu::render()
+{
     system_gui();
     system_render();
 }
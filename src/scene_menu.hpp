@@ -31,10 +31,15 @@ private:
     void init();
 
     /**
-     * @brief Update the scene
+     * @brief Update the scene by one fixed tick
      */
     void update() override;
 
+    /**
+     * @brief Draw the scene and its GUI
+     */
+    void render() override;
+
     /**
      * @brief Handle an action
      */
@@ -19,13 +19,16 @@ void ScenePlay::update()
     if (!m_paused) [[likely]]
     {
         m_entities.update();
-        system_movement();
-        system_sound();
-        system_lifespan();
-        system_collision();
-        system_animation();
+        m_entities.set_queries_locked(true);
+        m_scheduler.run(m_game->get_jobs());
+        m_entities.set_queries_locked(false);
+        flush_commands();
         m_current_frame++;
     }
+}
+
+void ScenePlay::render()
+{
     system_gui();
     system_render();
 }
@@ -64,20 +67,100 @@ void ScenePlay::init(const std::string &path)
     m_victory_text->setOrigin(0.5f * m_victory_text->getLocalBounds().size);
     m_victory_text->setPosition(0.5f * static_cast<sf::Vector2f>(m_game->get_window().getSize()));
 
+    /* Systems */
+    init_systems();
+
+    /* Collision layers, before the level creates its colliders */
+    load_collision_filters();
+
     /* Load level */
     load_level(path);
 }
 
-sf::Vector2f ScenePlay::grid_to_mid_pixel(float grid_x, float grid_y, const std::shared_ptr<Entity> &entity) noexcept
+void ScenePlay::init_systems()
+{
+    /* Scene members are not components: m_bullet_count (movement, lifespan, collision) and the player reset
+       (lifespan, collision) are only protected by the CInput write these systems share, so they never run together */
+    m_scheduler.add_system("Movement",
+                           component_mask<CTransform, CInput, CGravity, CJump>(),
+                           component_mask<CTransform, CInput, CGravity, CJump>(),
+                           [this]()
+                           { system_movement(); });
+    m_scheduler.add_system("Sound Effects",
+                           component_mask<CSound>(),
+                           component_mask<CSound>(),
+                           [this]()
+                           { system_sound(); });
+    m_scheduler.add_system("Lifespan",
+                           component_mask<CLifeSpan, CInput>(),
+                           component_mask<CInput>(),
+                           [this]()
+                           { system_lifespan(); });
+    m_scheduler.add_system("Collision",
+                           component_mask<CTransform, CBoundingBox, CBoundingConvex, CCollisionFilter, CAnimation, CInput, CGravity, CJump>(),
+                           component_mask<CTransform, CAnimation, CInput, CGravity, CJump>(),
+                           [this]()
+                           { system_collision(); });
+    m_scheduler.add_system("Animation",
+                           component_mask<CTransform, CInput, CJump, CState, CAnimation>(),
+                           component_mask<CState, CAnimation>(),
+                           [this]()
+                           { system_animation(); });
+
+    /* Build the query lists of the systems now, the scheduler forbids building them while systems run in parallel */
+    (void)m_entities.query<CTransform, CGravity>();
+    (void)m_entities.query<CLifeSpan>();
+    (void)m_entities.query<CSound>();
+}
+
+void ScenePlay::load_collision_filters()
+{
+    for (const auto &config : m_game->get_collision_config())
+    {
+        const auto tag{std::find(tag_names.begin(), tag_names.end(), std::string_view{config.tag})};
+        const auto layer{find_collision_layer(config.layer)};
+        if (tag == tag_names.end() || !layer)
+        {
+            std::cerr << std::format("Collision config: unknown tag {} or layer {}\n", config.tag, config.layer);
+            continue;
+        }
+
+        CollisionMask mask{};
+        for (const auto &name : config.mask)
+        {
+            if (const auto other{find_collision_layer(name)})
+            {
+                mask |= collision_layer_bit(*other);
+            }
+            else
+            {
+                std::cerr << std::format("Collision config: unknown layer {} in the mask of {}\n", name, config.tag);
+            }
+        }
+
+        m_collision_filters[static_cast<size_t>(tag - tag_names.begin())] = CCollisionFilter{collision_layer_bit(*layer), mask};
+    }
+}
+
+[[nodiscard]] const CCollisionFilter &ScenePlay::get_collision_filter(Tag tag) const noexcept
+{
+    return m_collision_filters[static_cast<size_t>(tag)];
+}
+
+sf::Vector2f ScenePlay::grid_to_mid_pixel(float grid_x, float grid_y, Entity entity) noexcept
 {
     sf::Vector2f result{m_grid_size.x * grid_x, m_grid_size.y * grid_y};
 
-    if (entity->has<CAnimation>()) [[likely]]
+    if (entity.has<CAnimation>()) [[likely]]
     {
-        const auto &animation{entity->get<CAnimation>()};
-        const auto &transform{entity->get<CTransform>()};
-        auto size{static_cast<sf::Vector2f>(animation.animation.get_size())};
-        size *= transform.scale;
+        const auto &animation{entity.get<CAnimation>()};
+        auto size{static_cast<sf::Vector2f>(animation.animation->get_size())};
+
+        /* Transform may not be added yet, in that case the scale is 1 */
+        if (entity.has<CTransform>())
+        {
+            size *= entity.get<CTransform>().scale;
+        }
         result += 0.5f * size;
     }
     result.y = m_game->get_window().getSize().y - result.y;
@@ -96,6 +179,7 @@ void ScenePlay::load_level(const std::string &path)
 
     std::string line;
     size_t line_idx{0};
+    std::vector<TileGrid::Tile> static_colliders{};
     while (std::getline(level, line))
     {
         line_idx++;
@@ -128,88 +212,101 @@ void ScenePlay::load_level(const std::string &path)
         std::string element_type{words[0]};
         if (element_type == "Tile")
         {
-            auto entity{m_entities.add_entity("tile")};
+            auto entity{m_entities.add_entity(Tag::Tile)};
             try
             {
                 /* AnimationName first, we use it for hitbox */
                 std::string animation_name{words[1]};
-                entity->add<CAnimation>(m_game->get_assets().get_animation(animation_name), true);
+                entity.add<CAnimation>(m_game->get_assets().get_animation(animation_name), true);
 
                 // Hitbox -> BoundingBox if tile
                 if (animation_name == "Flagpole")
                 {
-                    entity->add<CBoundingBox>(sf::Vector2f{64.0f, 64.0f}, sf::Vector2f{0.0f, 320.0f});
+                    entity.add<CBoundingBox>(sf::Vector2f{64.0f, 64.0f}, sf::Vector2f{0.0f, 320.0f});
                 }
                 else
                 {
-                    entity->add<CBoundingBox>(static_cast<sf::Vector2f>(m_game->get_assets().get_animation(animation_name).get_size()));
+                    entity.add<CBoundingBox>(static_cast<sf::Vector2f>(m_game->get_assets().get_animation(animation_name).get_size()));
                 }
                 /* Position, convert coords */
                 float x{}, y{};
                 x = std::stof(words[2]);
                 y = std::stof(words[3]);
-                entity->add<CTransform>(grid_to_mid_pixel(x, y, entity));
+                entity.add<CTransform>(grid_to_mid_pixel(x, y, entity));
+                entity.add<CCollisionFilter>(get_collision_filter(Tag::Tile));
             }
             catch (const std::exception &e)
             {
                 std::cerr << std::format("Error line {}: {}\n", line_idx, e.what());
-                entity->destroy();
+                entity.destroy();
                 continue;
             }
+
+            /* Static collider, stored once the level is loaded */
+            static_colliders.push_back(TileGrid::Tile{entity, get_tile_type(entity), Physics::get_bounds(entity), entity.get<CCollisionFilter>()});
         }
         else if (element_type == "Dec")
         {
             // No hitbox
-            auto entity{m_entities.add_entity("dec")};
+            auto entity{m_entities.add_entity(Tag::Dec)};
             try
             {
                 /* AnimationName first */
                 std::string animation_name{words[1]};
-                entity->add<CAnimation>(m_game->get_assets().get_animation(animation_name), true);
-                // entity->get<CAnimation>().animation.set_origin(OriginAnchor::BottomLeft);
+                entity.add<CAnimation>(m_game->get_assets().get_animation(animation_name), true);
+                // entity.get<CAnimation>().animation.set_origin(OriginAnchor::BottomLeft);
 
                 /* Position, convert coords */
                 float x{}, y{};
 
                 x = std::stof(words[2]);
                 y = std::stof(words[3]);
-                entity->add<CTransform>();
-                entity->get<CTransform>().scale *= 4.0f;
-                entity->get<CTransform>().pos = grid_to_mid_pixel(x, y, entity);
+                entity.add<CTransform>();
+                entity.get<CTransform>().scale *= 4.0f;
+                entity.get<CTransform>().pos = grid_to_mid_pixel(x, y, entity);
+                entity.get<CTransform>().previous_pos = entity.get<CTransform>().pos;
+                entity.add<CCollisionFilter>(get_collision_filter(Tag::Dec));
             }
             catch (const std::exception &e)
             {
                 std::cerr << std::format("Error line {}: {}\n", line_idx, e.what());
-                entity->destroy();
+                entity.destroy();
                 continue;
             }
         }
         else if (element_type == "Spike")
         {
-            auto entity{m_entities.add_entity("spike")};
+            auto entity{m_entities.add_entity(Tag::Spike)};
             try
             {
                 /* AnimationName first, we use it for hitbox */
                 std::string animation_name{words[1]};
-                entity->add<CAnimation>(m_game->get_assets().get_animation(animation_name), true);
+                entity.add<CAnimation>(m_game->get_assets().get_animation(animation_name), true);
 
                 // Hitbox -> BoundingConvex if spike
                 const std::vector<sf::Vector2f> tri{{sf::Vector2f{-0.5f, 0.5f}, sf::Vector2f{0.0f, -0.5f}, sf::Vector2f{0.5f, 0.5f}}};
-                entity->add<CBoundingConvex>(tri, static_cast<sf::Vector2f>(m_game->get_assets().get_animation(animation_name).get_size()));
+                entity.add<CBoundingConvex>(tri, static_cast<sf::Vector2f>(m_game->get_assets().get_animation(animation_name).get_size()));
 
                 /* Position, convert coords */
                 float x{}, y{};
 
                 x = std::stof(words[2]);
                 y = std::stof(words[3]);
-                entity->add<CTransform>(grid_to_mid_pixel(x, y, entity));
+                entity.add<CTransform>(grid_to_mid_pixel(x, y, entity));
+
+                /* Spikes never move, their world points are computed once */
+                Physics::cache_world_points(entity.get<CBoundingConvex>(), entity.get<CTransform>());
+                entity.add<CCollisionFilter>(get_collision_filter(Tag::Spike));
             }
             catch (const std::exception &e)
             {
                 std::cerr << std::format("Error line {}: {}\n", line_idx, e.what());
-                entity->destroy();
+                entity.destroy();
                 continue;
             }
+
+            /* Static collider, stored once the level is loaded */
+            static_colliders.push_back(TileGrid::Tile{entity, get_tile_type(entity), Physics::get_bounds(entity), entity.get<CCollisionFilter>()});
         }
         else if (element_type == "Player")
         {
@@ -237,6 +334,25 @@ void ScenePlay::load_level(const std::string &path)
         }
     }
 
+    /* Tiles filling exactly one cell go to the tile grid, the others are static bodies of the sweep */
+    const float ground_y{static_cast<float>(m_game->get_window().getSize().y)};
+    for (const auto &tile : m_tile_grid.build(ground_y, static_colliders))
+    {
+        m_sweep.insert_static(tile.entity, tile.bounds, tile.filter);
+    }
+
+    /* Solid tiles and bricks next to each other collide as a few rectangles */
+    m_tile_grid.merge();
+
+    /* The tree holds all of them, for the scene queries */
+    std::vector<StaticBvh::Collider> bvh_colliders{};
+    bvh_colliders.reserve(static_colliders.size());
+    for (const auto &tile : static_colliders)
+    {
+        bvh_colliders.push_back(StaticBvh::Collider{tile.entity, tile.bounds, tile.filter});
+    }
+    m_static_bvh.build(bvh_colliders);
+
     /* Spawn player in the scene */
     spawn_player();
 
@@ -246,41 +362,43 @@ void ScenePlay::load_level(const std::string &path)
 
 void ScenePlay::spawn_player()
 {
-    m_player = m_entities.add_entity("player");
-    m_player->add<CAnimation>(m_game->get_assets().get_animation("Idle"), true);
-    m_player->add<CTransform>(grid_to_mid_pixel(m_player_conf.x, m_player_conf.y, m_player)); // TODO: GridToMidPixel
-    m_player->add<CBoundingBox>(sf::Vector2f{m_player_conf.cx, m_player_conf.cy});            // TODO: Replace bouding box dims
+    m_player = m_entities.add_entity(Tag::Player);
+    m_player.add<CAnimation>(m_game->get_assets().get_animation("Idle"), true);
+    m_player.add<CTransform>(grid_to_mid_pixel(m_player_conf.x, m_player_conf.y, m_player)); // TODO: GridToMidPixel
+    m_player.add<CBoundingBox>(sf::Vector2f{m_player_conf.cx, m_player_conf.cy});            // TODO: Replace bouding box dims
 
     // TODO: Add remaining components
-    m_player->add<CInput>();
-    m_player->add<CGravity>(m_player_conf.gravity);
-    m_player->add<CState>("idle");
-    m_player->add<CJump>(m_player_conf.jump, 20, 1.0f); // Jump strength and duration
+    m_player.add<CInput>();
+    m_player.add<CGravity>(m_player_conf.gravity);
+    m_player.add<CState>(PlayerState::Idle);
+    m_player.add<CJump>(m_player_conf.jump, 20, 1.0f); // Jump strength and duration
+    m_player.add<CCollisionFilter>(get_collision_filter(Tag::Player));
 }
 
-void ScenePlay::spawn_bullet(const std::shared_ptr<Entity> &entity)
+void ScenePlay::spawn_bullet(CommandBuffer &commands, Entity entity)
 {
     // TODO: spawn a bullet at the given entity position, in the direction the entity is facing
-    if (!entity->has<CTransform>())
+    if (!entity.has<CTransform>())
         return;
 
-    if (!entity->has<CAnimation>())
+    if (!entity.has<CAnimation>())
         return;
 
     /* Bullet config */
     const auto &bullet_config{m_game->get_bullet_config()};
-    const auto &transform{entity->get<CTransform>()};
+    const auto &transform{entity.get<CTransform>()};
     const sf::Vector2f gun_offset{24.0f * transform.scale.x, 0.0f};
 
     /* Velocity according to the orientation of the entity */
-    auto bullet{m_entities.add_entity("bullet")};
-    bullet->add<CTransform>(transform.pos + gun_offset, sf::Vector2f(bullet_config.speed * transform.scale.x, 0.0f), transform.scale, 0.0f);
-    bullet->add<CAnimation>(m_game->get_assets().get_animation(m_player_conf.bullet), true);
-    bullet->add<CBoundingBox>(sf::Vector2f(bullet_config.radius, bullet_config.radius));
-    bullet->add<CLifeSpan>(bullet_config.lifespan, m_current_frame);
+    const auto bullet{commands.spawn(Tag::Bullet)};
+    commands.add<CTransform>(bullet, transform.pos + gun_offset, sf::Vector2f(bullet_config.speed * transform.scale.x, 0.0f), transform.scale, 0.0f);
+    commands.add<CAnimation>(bullet, m_game->get_assets().get_animation(m_player_conf.bullet), true);
+    commands.add<CBoundingBox>(bullet, sf::Vector2f(bullet_config.radius, bullet_config.radius), sf::Vector2f{0.0f, 0.0f}, bullet_config.swept);
+    commands.add<CLifeSpan>(bullet, bullet_config.lifespan, m_current_frame);
+    commands.add<CCollisionFilter>(bullet, get_collision_filter(Tag::Bullet));
 
     /* Player make a sound when shooting */
-    spawn_sound("Shoot", entity->get<CTransform>().pos);
+    spawn_sound(commands, "Shoot", entity.get<CTransform>().pos);
 
     m_bullet_count++;
 }
@@ -300,16 +418,29 @@ void ScenePlay::system_movement()
     static const float grav{m_player_conf.gravity};
 
     /* Player */
-    if (m_player->has<CInput>() && m_player->has<CTransform>() && m_player->has<CGravity>() && m_player->has<CJump>()) [[likely]]
+    if (m_player.has<CInput>() && m_player.has<CTransform>() && m_player.has<CGravity>() && m_player.has<CJump>()) [[likely]]
     {
-        auto &input{m_player->get<CInput>()};
-        auto &transform{m_player->get<CTransform>()};
-        auto &gravity{m_player->get<CGravity>()};
-        auto &jump{m_player->get<CJump>()};
+        auto &input{m_player.get<CInput>()};
+        auto &transform{m_player.get<CTransform>()};
+        auto &gravity{m_player.get<CGravity>()};
+        auto &jump{m_player.get<CJump>()};
+
+        /* A grounded player without input rests: no gravity pushes it into the ground, its transform is not changed
+           and the collision system keeps its contacts instead of testing the tiles again */
+        const bool resting{jump.grounded && !input.left && !input.right && !(input.up && input.can_jump)};
+        if (resting)
+        {
+            transform.velocity = {0.0f, 0.0f};
+            gravity.gravity = 0.0f;
+        }
 
         /* Resets player velocity and gravity */
-        transform.velocity.x = 0.0f;
-        gravity.gravity = grav;
+        else
+        {
+            m_player.mark_changed<CTransform>();
+            transform.velocity.x = 0.0f;
+            gravity.gravity = grav;
+        }
 
         /* Movement */
         if (input.left)
@@ -332,7 +463,7 @@ void ScenePlay::system_movement()
                 input.can_jump = false;
                 jump.jumping = true;
                 jump.start_frame = m_current_frame;
-                spawn_sound("Jump", m_player->get<CTransform>().pos);
+                spawn_sound(m_movement_commands, "Jump", m_player.get<CTransform>().pos);
             }
 
             else if (jump.jumping && m_current_frame - jump.start_frame < jump.max_duration)
@@ -344,30 +475,36 @@ void ScenePlay::system_movement()
         /* Shoot */
         if (input.shoot && input.can_shoot)
         {
-            spawn_bullet(m_player);
+            spawn_bullet(m_movement_commands, m_player);
             input.can_shoot = false;
         }
     }
 
-    /* Update entities based on velocity */
-    for (const auto &e : m_entities.get_entities())
-    {
-        if (!e->has<CTransform>()) [[unlikely]]
-        {
-            continue;
-        }
-
-        auto &transform{e->get<CTransform>()};
-
-        if (e->has<CGravity>()) [[unlikely]]
-        {
-            transform.velocity.y += e->get<CGravity>().gravity;
-            transform.velocity.y = std::min(transform.velocity.y, max_speed);
-        }
-
-        transform.previous_pos = transform.pos;
-        transform.pos += transform.velocity;
-    }
+    /* Apply gravity on entities that have it */
+    const auto &gravity_entities{m_entities.query<CTransform, CGravity>()};
+    m_game->get_jobs().parallel_for(gravity_entities.size(), parallel_grain, [&gravity_entities](size_t begin, size_t end)
+                                    {
+                                        for (size_t i = begin; i < end; ++i)
+                                        {
+                                            auto &transform{gravity_entities[i].get<CTransform>()};
+                                            Physics::apply_gravity(transform.velocity, gravity_entities[i].get<CGravity>().gravity, max_speed);
+                                        } });
+
+    /* Update entities based on velocity, only moving entities are marked as changed */
+    auto &transforms{m_entities.get_pool<CTransform>().components()};
+    auto &ticks{m_entities.get_pool<CTransform>().ticks()};
+    const uint32_t tick{m_entities.get_tick()};
+    m_game->get_jobs().parallel_for(transforms.size(), parallel_grain, [&transforms, &ticks, tick](size_t begin, size_t end)
+                                    {
+                                        for (size_t i = begin; i < end; ++i)
+                                        {
+                                            transforms[i].previous_pos = transforms[i].pos;
+                                            if (transforms[i].velocity.x != 0.0f || transforms[i].velocity.y != 0.0f)
+                                            {
+                                                Physics::integrate(transforms[i].pos, transforms[i].velocity);
+                                                ticks[i] = tick;
+                                            }
+                                        } });
 }
 
 void ScenePlay::system_lifespan()
@@ -376,42 +513,37 @@ void ScenePlay::system_lifespan()
         return;
 
     /* Bullet quantity */
-    auto &bullets{m_entities.get_entities("bullet")};
+    auto &bullets{m_entities.get_entities(Tag::Bullet)};
     bool first_bullet{true};
     for (const auto &b : bullets)
     {
-        if (!b->has<CLifeSpan>()) [[unlikely]]
+        if (!b.has<CLifeSpan>()) [[unlikely]]
         {
             continue;
         }
 
-        auto &ls{b->get<CLifeSpan>()};
+        auto &ls{b.get<CLifeSpan>()};
         if (m_current_frame - ls.frame_created == 15 && first_bullet)
         {
-            m_player->get<CInput>().can_shoot = true;
+            m_player.get<CInput>().can_shoot = true;
             first_bullet = false;
         }
     }
 
     if (m_bullet_count == 0)
     {
-        m_player->get<CInput>().can_shoot = true;
+        m_player.get<CInput>().can_shoot = true;
     }
 
     // TODO: Check lifespan of entities and destroy them if they go over
-    for (const auto &e : m_entities.get_entities())
+    for (const auto &e : m_entities.query<CLifeSpan>())
     {
-        if (!e->has<CLifeSpan>())
-        {
-            continue;
-        }
-
-        auto &ls{e->get<CLifeSpan>()};
+        auto &ls{e.get<CLifeSpan>()};
         if (m_current_frame - ls.frame_created >= ls.lifespan)
         {
-            e->destroy();
+            m_lifespan_commands.destroy(e);
 
-            if (e->tag() == "bullet") [[likely]]
+            if (e.tag() == Tag::Bullet) [[likely]]
             {
                 m_bullet_count--;
             }
@@ -441,49 +573,109 @@ void ScenePlay::system_collision()
     if (!m_collision)
         return;
 
-    /* Bullet - Tile collision */
-    for (const auto &bullet : m_entities.get_entities("bullet"))
+    /* Tiles and spikes are static, if the player did not move since the last pass it cannot hit something new */
+    const bool player_moved{m_player.changed_since<CTransform>(m_collision_tick)};
+    const sf::Vector2f player_start{m_player.get<CTransform>().pos};
+
+    /* Moving colliders are updated each frame, the sweep finds their pairs, tiles and spikes were stored by load_level */
+    for (const auto tag : {Tag::Player, Tag::Bullet, Tag::Coin})
     {
-        for (auto &tile : m_entities.get_entities("tile"))
+        for (const auto &entity : m_entities.get_entities(tag))
         {
-            if (!tile->has<CAnimation>()) [[unlikely]]
+            if (entity.has<CBoundingBox>())
             {
-                continue;
+                m_sweep.update_dynamic(entity, Physics::get_swept_bounds(entity), Physics::get_collision_filter(entity));
             }
+        }
+    }
+    m_sweep.update();
 
-            const auto overlap{Physics::get_current_overlap(bullet, tile)};
+    /* Contacts are only recorded here, gameplay reacts to them once the resolution is over */
+    m_contacts.begin_frame();
 
-            if (overlap.x <= 0.0f || overlap.y <= 0.0f) [[likely]]
-            {
-                continue;
-            }
+    /* Bullet - Tile collision, bullets are split in chunks tested in parallel, each chunk writes to its own buffer */
+    const auto &bullets{m_entities.get_entities(Tag::Bullet)};
+    const size_t chunk_count{(bullets.size() + narrowphase_grain - 1) / narrowphase_grain};
+    if (m_narrowphase_buffers.size() < chunk_count)
+    {
+        m_narrowphase_buffers.resize(chunk_count);
+    }
 
-            /* Destroy the tile if it's a brick tile */
-            auto &anim{tile->get<CAnimation>()};
-            if (anim.animation.get_name() == "Brick") [[unlikely]]
-            {
-                spawn_explosion(tile);
-            }
+    m_game->get_jobs().parallel_for(chunk_count, 1, [this, &bullets](size_t begin, size_t end)
+                                    {
+                                        for (size_t chunk = begin; chunk < end; ++chunk)
+                                        {
+                                            auto &buffer{m_narrowphase_buffers[chunk]};
+                                            buffer.contacts.clear();
+
+                                            const size_t last{std::min((chunk + 1) * narrowphase_grain, bullets.size())};
+                                            for (size_t i = chunk * narrowphase_grain; i < last; ++i)
+                                            {
+                                                find_bullet_contacts(bullets[i], buffer);
+                                            }
+                                        } });
+
+    /* Merge in entity id order, the contacts are the same whatever the number of threads */
+    m_bullet_contacts.clear();
+    for (size_t chunk = 0; chunk < chunk_count; ++chunk)
+    {
+        const auto &contacts{m_narrowphase_buffers[chunk].contacts};
+        m_bullet_contacts.insert(m_bullet_contacts.end(), contacts.begin(), contacts.end());
+    }
+    std::stable_sort(m_bullet_contacts.begin(), m_bullet_contacts.end(), [](const PendingContact &lhs, const PendingContact &rhs)
+                     { return lhs.a.id() < rhs.a.id() || (lhs.a.id() == rhs.a.id() && lhs.b.id() < rhs.b.id()); });
 
-            /* Destroy the bullet */
-            bullet->destroy();
-            if (m_bullet_count > 0)
-            {
-                m_bullet_count--;
-            }
-        }
+    for (const auto &contact : m_bullet_contacts)
+    {
+        m_contacts.report(contact.a, contact.b, contact.normal, contact.penetration, contact.velocity);
     }
 
-    /* Player - tile collision */
-    for (const auto &tile : m_entities.get_entities("tile"))
+    /* The player is resolved against the world layer, then tested against the hazard layer */
+    const auto player_filter{Physics::get_collision_filter(m_player)};
+    const CCollisionFilter world_filter{player_filter.layer, player_filter.mask & collision_layer_bit(CollisionLayer::World)};
+    const CCollisionFilter hazard_filter{player_filter.layer, player_filter.mask & collision_layer_bit(CollisionLayer::Hazard)};
+
+    /* Player - tile collision, tiles and merged rectangles of tiles */
+    m_candidates.clear();
+    m_merged_candidates.clear();
+    if (player_moved && m_player.has<CBoundingBox>())
     {
-        if (!m_player->has<CBoundingBox>() || !tile->has<CBoundingBox>())
+        const auto bounds{Physics::get_bounds(m_player)};
+        m_sweep.get_partners(m_player, m_candidates);
+        m_tile_grid.query(bounds, world_filter, m_candidates);
+        m_tile_grid.query_merged(bounds, world_filter, m_merged_candidates);
+    }
+    else
+    {
+        /* Nothing is tested, the player keeps its contacts */
+        m_contacts.retain(m_player);
+    }
+
+    m_candidate_boxes.clear();
+    for (const auto &tile : m_candidates)
+    {
+        if (Physics::can_collide(world_filter, Physics::get_collision_filter(tile)))
         {
-            continue;
+            m_candidate_boxes.push(tile);
         }
+    }
+    for (const auto index : m_merged_candidates)
+    {
+        m_candidate_boxes.push(m_tile_grid.get_merged_bounds(index), Entity{});
+    }
 
-        const auto overlap{Physics::get_current_overlap(m_player, tile)};
-        const auto p_overlap{Physics::get_previous_overlap(m_player, tile)};
+    m_hits.clear();
+    if (!m_candidate_boxes.entities.empty())
+    {
+        Physics::get_current_overlaps(Physics::make_query_box(m_player), m_candidate_boxes, m_hits);
+    }
+
+    for (const auto &hit : m_hits)
+    {
+        /* Previous resolutions may have moved the player, the current overlap is computed again */
+        const auto player_box{Physics::make_query_box(m_player)};
+        const auto overlap{Physics::get_current_overlap(player_box, m_candidate_boxes, hit.index)};
+        const auto &p_overlap{hit.previous_overlap};
 
         /* No collision */
         if (overlap.x == 0.0f || overlap.y == 0.0f) [[likely]]
@@ -491,185 +683,291 @@ void ScenePlay::system_collision()
             continue;
         }
 
-        auto &player_transform{m_player->get<CTransform>()};
-        auto &tile_transform{tile->get<CTransform>()};
-        auto &offset{tile->get<CBoundingBox>().offset};
+        /* Merged rectangles have no entity, the tile touched is the one at the center of the overlap */
+        auto tile{m_candidate_boxes.entities[hit.index]};
+        if (!tile.is_valid())
+        {
+            tile = m_tile_grid.get_tile(Physics::get_overlap_center(player_box, m_candidate_boxes, hit.index)).entity;
+        }
 
-        // Relative position for collision direction
-        const sf::Vector2f player_center{player_transform.pos + m_player->get<CBoundingBox>().half_size};
-        const sf::Vector2f tile_center{tile_transform.pos + offset + tile->get<CBoundingBox>().half_size};
-        const sf::Vector2f relative_pos{player_center - tile_center};
+        auto &player_transform{m_player.get<CTransform>()};
 
-        // Collision axis based on previous frame
-        static constexpr float epsilon{2.0f};
-        bool was_separated_x{std::abs(p_overlap.x) <= epsilon};
-        bool was_separated_y{std::abs(p_overlap.y) <= epsilon};
+        // Relative position for collision direction, from the centers of the boxes
+        const sf::Vector2f tile_center{m_candidate_boxes.center_x[hit.index], m_candidate_boxes.center_y[hit.index]};
+        const sf::Vector2f relative_pos{player_box.center - tile_center};
 
         // Collision direction
+        static constexpr float epsilon{Physics::resolution_epsilon};
         float collision_direction_x{(relative_pos.x > 0.0f) ? 1.0f : -1.0f};
         float collision_direction_y{(relative_pos.y > 0.0f) ? 1.0f : -1.0f};
 
-        // Primary collision detection
-        bool collision_on_x{was_separated_x && !was_separated_y};
-        bool collision_on_y{was_separated_y && !was_separated_x};
+        /* A contact of the last frame keeps its axis, standing on the ground or pushing a wall does not jitter */
+        bool solve_on_x{};
+        const auto cached{m_contacts.get_previous(m_player, tile)};
+        if (cached && cached->normal != sf::Vector2f{0.0f, 0.0f})
+        {
+            solve_on_x = cached->normal.x != 0.0f;
+        }
+
+        /* New contact, the collision axis is the one that was separated in the previous frame */
+        else
+        {
+            bool was_separated_x{std::abs(p_overlap.x) <= epsilon};
+            bool was_separated_y{std::abs(p_overlap.y) <= epsilon};
+
+            // Primary collision detection, the smallest overlap solves the ambiguous case
+            bool collision_on_x{was_separated_x && !was_separated_y};
+            bool collision_on_y{was_separated_y && !was_separated_x};
+            solve_on_x = collision_on_x || (!collision_on_y && overlap.x < overlap.y);
+        }
 
         /* Solve on the X-axis */
-        if (collision_on_x)
+        if (solve_on_x)
         {
             /* Add epsilon to fix issues with stacked entities */
-            player_transform.pos.x += (overlap.x + epsilon) * collision_direction_x;
+            player_transform.pos.x = Physics::push_out(player_transform.pos.x, overlap.x, epsilon, collision_direction_x);
+            m_contacts.report(m_player, tile, sf::Vector2f{collision_direction_x, 0.0f}, overlap.x, player_transform.velocity);
+            continue;
         }
 
         /* Solve on the Y-axis */
-        else if (collision_on_y)
-        {
-            player_transform.pos.y += overlap.y * collision_direction_y;
-
-            /* Tile is below the player */
-            if (collision_direction_y < 0.0f && player_transform.velocity.y >= 0.0f)
-            {
-                player_transform.velocity.y = 0.0f;
-                m_player->get<CInput>().can_jump = true;
-                m_player->get<CGravity>().gravity = 0.0f;
-                m_player->get<CJump>().jumping = false;
-
-                if (!tile->has<CAnimation>()) [[unlikely]]
-                {
-                    continue;
-                }
+        player_transform.pos.y = Physics::push_out(player_transform.pos.y, overlap.y, 0.0f, collision_direction_y);
+        m_contacts.report(m_player, tile, sf::Vector2f{0.0f, collision_direction_y}, overlap.y, player_transform.velocity);
 
-                /* Tile is a flagpole -> Player wins ! */
-                auto &anim{tile->get<CAnimation>()};
+        /* Tile below the player and falling, or above the player and going up */
+        if ((collision_direction_y < 0.0f && player_transform.velocity.y >= 0.0f) ||
+            (collision_direction_y > 0.0f && player_transform.velocity.y <= 0.0f))
+        {
+            player_transform.velocity.y = 0.0f;
+        }
+    }
 
-                /* Send back to the start of the level */
-                if (anim.animation.get_name() == "Flagpole")
-                {
-                    m_draw_victory_text = true;
-                    reset_player();
-                    spawn_sound("Win", m_player->get<CTransform>().pos);
-                }
-            }
+    /* Player - Spike collision, the player may have been moved by the tiles */
+    m_candidates.clear();
+    if (player_moved && m_player.has<CBoundingBox>())
+    {
+        m_sweep.get_partners(m_player, m_candidates);
+        m_tile_grid.query(Physics::get_bounds(m_player), hazard_filter, m_candidates);
+    }
 
-            /* Tile is above the player */
-            else if (collision_direction_y > 0.0f && player_transform.velocity.y <= 0.0f)
-            {
-                player_transform.velocity.y = 0.0f;
+    for (const auto &spike : m_candidates)
+    {
+        if (!spike.has<CBoundingConvex>() || !Physics::can_collide(hazard_filter, Physics::get_collision_filter(spike))) [[unlikely]]
+        {
+            continue;
+        }
 
-                /* Check if player can interact with tile */
-                if (!tile->has<CAnimation>()) [[unlikely]]
-                {
-                    continue;
-                }
+        const auto overlap{Physics::get_current_overlap_between_convex_and_box(spike, m_player)};
+        if (overlap.x != 0.0f || overlap.y != 0.0f)
+        {
+            m_contacts.report(m_player, spike, sf::Vector2f{0.0f, 0.0f}, std::max(std::abs(overlap.x), std::abs(overlap.y)),
+                              m_player.get<CTransform>().velocity);
+        }
+    }
 
-                auto &anim{tile->get<CAnimation>()};
+    m_contacts.end_frame();
 
-                if (anim.animation.get_name() == "Brick")
-                {
-                    spawn_debris(tile);
-                }
+    /* The player stands on the ground if one of its contacts pushes it up */
+    bool grounded{false};
+    m_contacts.for_each_contact(m_player, [&grounded](const ContactEvent &contact)
+                                { grounded = grounded || contact.normal.y < 0.0f; });
 
-                else if (anim.animation.get_name() == "Question")
-                {
-                    tile->get<CAnimation>().animation = m_game->get_assets().get_animation("QuestionHit");
-                    spawn_coin(tile);
-                }
-            }
-        }
+    grounded = grounded && m_player.get<CTransform>().velocity.y >= 0.0f;
+    m_player.get<CJump>().grounded = grounded;
+    if (grounded)
+    {
+        m_player.get<CInput>().can_jump = true;
+        m_player.get<CGravity>().gravity = 0.0f;
+        m_player.get<CJump>().jumping = false;
+    }
 
-        /* Ambiguous case */
-        else
-        {
-            if (overlap.x < overlap.y)
-            {
-                /* Add epsilon to fix issues with stacked entities */
-                player_transform.pos.x += (overlap.x + epsilon) * collision_direction_x;
-            }
-            else
-            {
-                player_transform.pos.y += overlap.y * collision_direction_y;
+    /* Gameplay */
+    handle_contacts();
 
-                /* Tile under player */
-                if (collision_direction_y < 0.0f && player_transform.velocity.y >= 0.0f)
-                {
-                    player_transform.velocity.y = 0.0f;
-                    m_player->get<CInput>().can_jump = true;
-                    m_player->get<CGravity>().gravity = 0.0f;
-                    m_player->get<CJump>().jumping = false;
+    /* Player - left wall collision */
+    if (m_player.get<CTransform>().pos.x < m_player.get<CBoundingBox>().half_size.x)
+    {
+        m_player.get<CTransform>().pos.x = m_player.get<CBoundingBox>().half_size.x;
+    }
 
-                    if (!tile->has<CAnimation>()) [[unlikely]]
-                    {
-                        continue;
-                    }
+    /* Player - fall of the map, restart to beginning */
+    if (m_player.get<CTransform>().pos.y > m_game->get_window().getSize().y)
+    {
+        reset_player();
+        spawn_sound(m_collision_commands, "Hurt", m_player.get<CTransform>().pos);
+    }
 
-                    /* Tile is a flagpole -> Player wins ! */
-                    auto &anim{tile->get<CAnimation>()};
+    if (m_player.get<CTransform>().pos != player_start)
+    {
+        m_player.mark_changed<CTransform>();
+    }
+    m_collision_tick = m_entities.get_tick();
+}
 
-                    /* Send back to the start of the level */
-                    if (anim.animation.get_name() == "Flagpole")
-                    {
-                        m_draw_victory_text = true;
-                        reset_player();
-                        spawn_sound("Win", m_player->get<CTransform>().pos);
-                    }
-                }
+void ScenePlay::find_bullet_contacts(Entity bullet, NarrowphaseBuffer &buffer) const
+{
+    if (!bullet.has<CBoundingBox>() || !bullet.has<CTransform>()) [[unlikely]]
+    {
+        return;
+    }
 
-                /* Tile above player */
-                else if (collision_direction_y > 0.0f && player_transform.velocity.y <= 0.0f)
-                {
-                    player_transform.velocity.y = 0.0f;
+    /* Only the tiles of the cells around the bullet, or around its motion if swept, on the layers of the bullet's mask */
+    const auto bounds{Physics::get_swept_bounds(bullet)};
+    const auto filter{Physics::get_collision_filter(bullet)};
+    buffer.candidates.clear();
+    m_sweep.get_partners(bullet, buffer.candidates);
+    m_tile_grid.query(bounds, filter, buffer.candidates);
+    m_tile_grid.query_merged(bounds, filter, buffer.merged_candidates);
+
+    /* Test all the candidate boxes at once */
+    buffer.boxes.clear();
+    for (const auto &tile : buffer.candidates)
+    {
+        buffer.boxes.push(tile);
+    }
+    for (const auto index : buffer.merged_candidates)
+    {
+        buffer.boxes.push(m_tile_grid.get_merged_bounds(index), Entity{});
+    }
 
-                    /* Check if player can interact with tile */
-                    if (!tile->has<CAnimation>()) [[unlikely]]
-                    {
-                        continue;
-                    }
+    const auto query{Physics::make_query_box(bullet)};
 
-                    auto &anim{tile->get<CAnimation>()};
+    /* Swept bullet: only the first tile on its way since the last frame */
+    if (bullet.get<CBoundingBox>().swept)
+    {
+        Physics::SweepHit hit{};
+        if (!Physics::get_first_sweep_hit(query, buffer.boxes, hit))
+        {
+            return;
+        }
 
-                    if (anim.animation.get_name() == "Brick")
-                    {
-                        spawn_debris(tile);
-                    }
+        /* Merged rectangles have no entity, the tile hit is the one next to the contact */
+        auto tile{buffer.boxes.entities[hit.index]};
+        if (!tile.is_valid())
+        {
+            tile = m_tile_grid.get_tile(Physics::get_sweep_contact(query, buffer.boxes, hit)).entity;
+        }
+        buffer.contacts.push_back(PendingContact{bullet, tile, hit.normal, 0.0f, bullet.get<CTransform>().velocity});
+        return;
+    }
 
-                    else if (anim.animation.get_name() == "Question")
-                    {
-                        tile->get<CAnimation>().animation = m_game->get_assets().get_animation("QuestionHit");
-                        spawn_coin(tile);
-                    }
-                }
-            }
+    Physics::get_current_overlaps(query, buffer.boxes, buffer.hits);
+    for (const auto &hit : buffer.hits)
+    {
+        /* Merged rectangles have no entity, the tile hit is the one at the center of the overlap */
+        auto tile{buffer.boxes.entities[hit.index]};
+        if (!tile.is_valid())
+        {
+            tile = m_tile_grid.get_tile(Physics::get_overlap_center(query, buffer.boxes, hit.index)).entity;
         }
+
+        const auto normal{Physics::get_overlap_normal(query, buffer.boxes, hit.index, hit.overlap)};
+        buffer.contacts.push_back(PendingContact{bullet, tile, normal, std::min(hit.overlap.x, hit.overlap.y), bullet.get<CTransform>().velocity});
     }
+}
 
-    /* Player - Spike collision */
-    for (const auto &spike : m_entities.get_entities("spike"))
+void ScenePlay::handle_contacts()
+{
+    /* Contacts of a bullet are reported one after the other, sorted by (bullet, tile) */
+    Entity last_bullet{};
+    ContactEvent event{};
+    while (m_contacts.pop(event))
     {
-        if (!spike->has<CBoundingConvex>() || !m_player->has<CBoundingBox>()) [[unlikely]]
+        /* Nothing reacts to the end of a contact yet */
+        if (event.phase == ContactPhase::End)
         {
             continue;
         }
 
-        const auto overlap{Physics::get_current_overlap_between_convex_and_box(spike, m_player)};
+        switch (event.a.tag())
+        {
+        case Tag::Bullet:
+            handle_bullet_contact(event, event.a != last_bullet);
+            last_bullet = event.a;
+            break;
+        case Tag::Player:
+            handle_player_contact(event);
+            break;
+        default:
+            break;
+        }
+    }
+}
 
+void ScenePlay::handle_bullet_contact(const ContactEvent &event, bool first_contact)
+{
+    /* Destroy the tile if it's a brick tile */
+    const auto &tile{event.b};
+    if (tile.has<CAnimation>() && tile.get<CAnimation>().animation->get_name() == "Brick") [[unlikely]]
+    {
+        spawn_explosion(m_collision_commands, tile);
+    }
+
+    /* Destroy the bullet, a bullet touching several tiles is destroyed and counted once */
+    if (!first_contact)
+    {
+        return;
+    }
+
+    m_collision_commands.destroy(event.a);
+    if (m_bullet_count > 0)
+    {
+        m_bullet_count--;
+    }
+}
+
+void ScenePlay::handle_player_contact(const ContactEvent &event)
+{
+    const auto &other{event.b};
+
+    /* Player - Spike, only when it goes deep enough in the spike */
+    if (other.tag() == Tag::Spike)
+    {
         constexpr float hit_spike_threshold{8.0f};
-        if (std::abs(overlap.x) >= hit_spike_threshold || std::abs(overlap.y) >= hit_spike_threshold)
+        if (event.penetration >= hit_spike_threshold)
         {
             reset_player();
-            spawn_sound("Hurt", m_player->get<CTransform>().pos);
+            spawn_sound(m_collision_commands, "Hurt", m_player.get<CTransform>().pos);
         }
+        return;
     }
 
-    /* Player - left wall collision */
-    if (m_player->get<CTransform>().pos.x < m_player->get<CBoundingBox>().half_size.x)
+    /* Check if player can interact with tile */
+    if (other.tag() != Tag::Tile || !other.has<CAnimation>()) [[unlikely]]
     {
-        m_player->get<CTransform>().pos.x = m_player->get<CBoundingBox>().half_size.x;
+        return;
     }
 
-    /* Player - fall of the map, restart to beginning */
-    if (m_player->get<CTransform>().pos.y > m_game->get_window().getSize().y)
+    /* Tiles react once, when the contact begins, like the baseline only when the player falls on them or jumps into them */
+    if (event.phase != ContactPhase::Begin)
     {
+        return;
+    }
+
+    const auto &name{other.get<CAnimation>().animation->get_name()};
+
+    /* Tile is below the player, a flagpole -> Player wins ! Send back to the start of the level */
+    if (event.normal.y < 0.0f && event.velocity.y >= 0.0f && name == "Flagpole")
+    {
+        m_draw_victory_text = true;
         reset_player();
-        spawn_sound("Hurt", m_player->get<CTransform>().pos);
+        spawn_sound(m_collision_commands, "Win", m_player.get<CTransform>().pos);
+    }
+
+    /* Tile is above the player */
+    else if (event.normal.y > 0.0f && event.velocity.y <= 0.0f)
+    {
+        if (name == "Brick")
+        {
+            spawn_debris(m_collision_commands, other);
+        }
+
+        else if (name == "Question")
+        {
+            other.get<CAnimation>() = CAnimation(m_game->get_assets().get_animation("QuestionHit"), true);
+            other.mark_changed<CAnimation>();
+            spawn_coin(m_collision_commands, other);
+        }
     }
 }
 
@@ -682,13 +980,13 @@ void ScenePlay::system_animation()
     constexpr static float eps{0.1f};
 
     /* Check player state and update it based on its movement*/
-    if (m_player->has<CTransform>() && m_player->has<CState>() && m_player->has<CInput>() && m_player->has<CJump>()) [[likely]]
+    if (m_player.has<CTransform>() && m_player.has<CState>() && m_player.has<CInput>() && m_player.has<CJump>()) [[likely]]
     {
         // Check if player is moving, jumping, shooting or air shooting
-        const auto &transform{m_player->get<CTransform>()};
-        const auto &input{m_player->get<CInput>()};
-        const auto &jump{m_player->get<CJump>()};
-        auto &state{m_player->get<CState>()};
+        const auto &transform{m_player.get<CTransform>()};
+        const auto &input{m_player.get<CInput>()};
+        const auto &jump{m_player.get<CJump>()};
+        auto &state{m_player.get<CState>()};
 
         const bool just_jumped{input.up && input.can_jump};
         const bool in_air{std::abs(transform.velocity.y) > eps || !input.can_jump || just_jumped || jump.jumping};
@@ -699,9 +997,9 @@ void ScenePlay::system_animation()
         {
             // Either just in the air or jump and shoot
             if (input.shoot)
-                change_player_state_to(state, "air_shoot");
+                change_player_state_to(state, PlayerState::AirShoot);
             else
-                change_player_state_to(state, "air");
+                change_player_state_to(state, PlayerState::Air);
         }
 
         // Moving on the ground
@@ -709,59 +1007,70 @@ void ScenePlay::system_animation()
         {
             // Either just moving or move and shoot
             if (input.shoot)
-                change_player_state_to(state, "run_shoot");
+                change_player_state_to(state, PlayerState::RunShoot);
             else
-                change_player_state_to(state, "run");
+                change_player_state_to(state, PlayerState::Run);
         }
         // Not moving
         else
         {
             // Either idle or shoot
             if (input.shoot)
-                change_player_state_to(state, "idle_shoot");
+                change_player_state_to(state, PlayerState::IdleShoot);
             else
-                change_player_state_to(state, "idle");
+                change_player_state_to(state, PlayerState::Idle);
         }
 
         /* Change player animation based on state */
         if (state.change_animation)
         {
-            static const std::unordered_map<std::string, std::string> animation_map{{
-                {"idle", "Idle"},
-                {"idle_shoot", "IdleShoot"},
-                {"run", "Run"},
-                {"run_shoot", "RunShoot"},
-                {"air", "Air"},
-                {"air_shoot", "AirShoot"},
-            }};
-
-            const auto it{animation_map.find(state.state)};
-            const std::string &animation_name{it != animation_map.end() ? it->second : "Idle"};
-
-            m_player->add<CAnimation>(m_game->get_assets().get_animation(animation_name), true);
+            /* Animation of each PlayerState, in the same order */
+            static constexpr std::array<const char *, 6> animation_names{
+                "Idle",
+                "IdleShoot",
+                "Run",
+                "RunShoot",
+                "Air",
+                "AirShoot"};
+
+            const char *animation_name{animation_names[static_cast<size_t>(state.state)]};
+
+            m_player.get<CAnimation>() = CAnimation(m_game->get_assets().get_animation(animation_name), true);
+            m_player.mark_changed<CAnimation>();
         }
     }
 
-    /* Update animations */
-    for (const auto &e : m_entities.get_entities())
+    /* Destroy entity if animation has ended and is not repeated */
+    auto &animations{m_entities.get_pool<CAnimation>()};
+    for (size_t i = 0; i < animations.size(); ++i)
     {
-        if (!e->has<CAnimation>()) [[unlikely]]
+        const auto &anim{animations.components()[i]};
+        if (anim.animation->has_ended(anim.current_frame) && !anim.repeat)
         {
-            continue;
+            m_animation_commands.destroy(m_entities.get_entity(animations.entities()[i]));
         }
+    }
 
-        auto &anim{e->get<CAnimation>()};
+    /* Update the other animations, split between threads */
+    m_game->get_jobs().parallel_for(animations.size(), parallel_grain, [&animations](size_t begin, size_t end)
+                                    {
+                                        for (size_t i = begin; i < end; ++i)
+                                        {
+                                            auto &anim{animations.components()[i]};
+                                            if (!anim.animation->has_ended(anim.current_frame) || anim.repeat)
+                                            {
+                                                anim.current_frame++;
+                                            }
+                                        } });
+}
 
-        /* Destroy entity if animation has ended and is not repeated */
-        if (anim.animation.has_ended() && !anim.repeat)
-        {
-            e->destroy();
-        }
-        else
-        {
-            anim.animation.update();
-        }
-    }
+void ScenePlay::flush_commands()
+{
+    m_movement_commands.flush(m_entities);
+    m_sound_commands.flush(m_entities);
+    m_lifespan_commands.flush(m_entities);
+    m_collision_commands.flush(m_entities);
+    m_animation_commands.flush(m_entities);
 }
 
 void ScenePlay::system_gui()
@@ -778,6 +1087,14 @@ void ScenePlay::system_gui()
             ImGui::Checkbox("Hitboxes", &m_draw_collision);
             ImGui::Checkbox("Grid", &m_draw_grid);
             ImGui::Checkbox("Victory Text", &m_draw_victory_text);
+
+            /* Fixed tick loop */
+            const auto &tick_stats{m_game->get_tick_stats()};
+            ImGui::SeparatorText("Ticks");
+            ImGui::Text("Tick rate: %u Hz", m_game->get_window_config().tick_rate);
+            ImGui::Text("Ticks: %zu (%u this frame)", tick_stats.ticks, tick_stats.frame_ticks);
+            ImGui::Text("Dropped ticks: %zu in %zu frames", tick_stats.dropped_ticks, tick_stats.clamped_frames);
+            ImGui::Text("Interpolation: %.2f", tick_stats.interpolation);
             ImGui::EndTabItem();
         }
 
@@ -791,6 +1108,175 @@ void ScenePlay::system_gui()
             ImGui::Checkbox("Collision", &m_collision);
             ImGui::Checkbox("Animation", &m_animation);
             ImGui::Checkbox("Render", &m_render);
+
+            /* Systems run at the same time unless they conflict */
+            ImGui::SeparatorText("Dependencies");
+            ImGui::Text("Threads: %zu", m_game->get_jobs().size() + 1);
+            const auto &systems{m_scheduler.get_systems()};
+            for (const auto &system : systems)
+            {
+                std::string names{};
+                for (const auto index : system.dependencies)
+                {
+                    names += (names.empty() ? "" : ", ") + systems[index].name;
+                }
+                ImGui::Text("%s: after %s", system.name.c_str(), names.empty() ? "nothing" : names.c_str());
+            }
+            ImGui::EndTabItem();
+        }
+
+        /* Broadphase counters of the last frame */
+        if (ImGui::BeginTabItem("Collision"))
+        {
+            const auto &stats{m_sweep.get_stats()};
+            const size_t possible_pairs{stats.bodies > 1 ? stats.bodies * (stats.bodies - 1) / 2 : 0};
+
+            ImGui::SeparatorText("Sweep and prune");
+            ImGui::Text("Bodies: %zu (%zu dynamic)", stats.bodies, stats.dynamic_bodies);
+            ImGui::Text("Endpoint swaps: %zu", stats.swaps);
+            ImGui::Text("Pairs overlapping on x: %zu (%zu rejected by layers)", stats.tests + stats.filtered, stats.filtered);
+            ImGui::Text("Pairs overlapping: %zu / %zu possible", stats.pairs, possible_pairs);
+
+            ImGui::SeparatorText("Tile grid");
+            ImGui::Text("Cells: %d x %d", m_tile_grid.get_width(), m_tile_grid.get_height());
+            ImGui::Text("Merged colliders: %zu (%zu tiles)", m_tile_grid.get_merged_count(), m_tile_grid.get_merged_tile_count());
+
+            const auto &bvh_stats{m_static_bvh.get_stats()};
+            ImGui::SeparatorText("Static BVH");
+            ImGui::Text("Colliders: %zu (%zu removed)", bvh_stats.colliders, bvh_stats.removed);
+            ImGui::Text("Nodes: %zu (%zu leaves), depth %zu, %.1f KiB", bvh_stats.nodes, bvh_stats.leaves, bvh_stats.depth,
+                        static_cast<float>(bvh_stats.memory_bytes) / 1024.0f);
+            ImGui::Text("Refits: %zu, rebuilds: %zu", bvh_stats.refits, bvh_stats.rebuilds);
+
+            ImGui::SeparatorText("Contacts");
+            ImGui::Text("Contacts: %zu", m_contacts.get_contact_count());
+            ImGui::Text("Events dropped: %zu", m_contacts.get_dropped());
+            ImGui::Text("Contacts retained: %zu", m_contacts.get_retained()); // Not 0 while the player rests on the ground
+            m_contacts.for_each_contact(m_player, [](const ContactEvent &contact)
+                                        { ImGui::BulletText("Player - %s %zu: normal (%.0f, %.0f), overlap %.1f, %u frames", tag_name(contact.b.tag()),
+                                                            contact.b.id(), contact.normal.x, contact.normal.y, contact.penetration, contact.age); });
+
+            ImGui::SeparatorText("Queries");
+            if (m_player.is_alive())
+            {
+                const auto filter{Physics::get_collision_filter(m_player)};
+                const auto facing{sf::Vector2f{m_player.get<CTransform>().scale.x, 0.0f}};
+
+                Physics::BoxCastHit ground{};
+                if (m_world_query.cast_box(Physics::get_bounds(m_player), sf::Vector2f{0.0f, ground_probe_distance}, filter, m_player, ground))
+                {
+                    ImGui::Text("Ground below the player: %s %zu, %.1f px", tag_name(ground.entity.tag()), ground.entity.id(), ground.time * ground_probe_distance);
+                }
+                else
+                {
+                    ImGui::Text("Ground below the player: none within %.0f px", ground_probe_distance);
+                }
+
+                Physics::RayHit sight{};
+                if (m_world_query.raycast(m_player.get<CTransform>().pos, facing, sight_distance, filter, m_player, sight))
+                {
+                    ImGui::Text("Line of sight: %s %zu at %.1f px", tag_name(sight.entity.tag()), sight.entity.id(), sight.distance);
+                }
+                else
+                {
+                    ImGui::Text("Line of sight: clear for %.0f px", sight_distance);
+                }
+            }
+            ImGui::EndTabItem();
+        }
+
+        /* Job system scaling, static collider queries and number types, on synthetic workloads */
+        if (ImGui::BeginTabItem("Benchmark"))
+        {
+            if (ImGui::Button("Run job system benchmark"))
+            {
+                m_benchmark_results = Benchmark::job_system_scaling(200000, 20);
+            }
+
+            if (!m_benchmark_results.empty() && ImGui::BeginTable("BenchmarkTable", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+            {
+                ImGui::TableSetupColumn("Threads");
+                ImGui::TableSetupColumn("Time (ms)");
+                ImGui::TableSetupColumn("Speedup");
+                ImGui::TableHeadersRow();
+
+                for (const auto &result : m_benchmark_results)
+                {
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::Text("%zu", result.threads);
+                    ImGui::TableSetColumnIndex(1);
+                    ImGui::Text("%.2f", result.milliseconds);
+                    ImGui::TableSetColumnIndex(2);
+                    ImGui::Text("%.2fx", m_benchmark_results.front().milliseconds / result.milliseconds);
+                }
+                ImGui::EndTable();
+            }
+
+            /* Static collider structures on a generated level */
+            if (ImGui::Button("Run static query benchmark (50k tiles)"))
+            {
+                m_query_benchmark_results = Benchmark::static_queries(50000, 10000);
+            }
+
+            if (!m_query_benchmark_results.empty() && ImGui::BeginTable("QueryBenchmarkTable", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+            {
+                ImGui::TableSetupColumn("Method");
+                ImGui::TableSetupColumn("Build (ms)");
+                ImGui::TableSetupColumn("10k overlaps (ms)");
+                ImGui::TableSetupColumn("10k raycasts (ms)");
+                ImGui::TableSetupColumn("Memory (KiB)");
+                ImGui::TableSetupColumn("Hits");
+                ImGui::TableHeadersRow();
+
+                for (const auto &result : m_query_benchmark_results)
+                {
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::Text("%s", result.method);
+                    ImGui::TableSetColumnIndex(1);
+                    ImGui::Text("%.2f", result.build_milliseconds);
+                    ImGui::TableSetColumnIndex(2);
+                    ImGui::Text("%.2f", result.overlap_milliseconds);
+                    ImGui::TableSetColumnIndex(3);
+                    ImGui::Text("%.2f", result.raycast_milliseconds);
+                    ImGui::TableSetColumnIndex(4);
+                    ImGui::Text("%zu", result.memory_bytes / 1024);
+                    ImGui::TableSetColumnIndex(5);
+                    ImGui::Text("%zu / %zu", result.overlap_hits, result.raycast_hits);
+                }
+                ImGui::EndTable();
+            }
+
+            /* Both number types run whatever the build mode, the fixed point checksum never changes */
+            ImGui::Text("Simulation numbers: %s", Physics::real_name);
+            if (ImGui::Button("Run fixed point benchmark"))
+            {
+                m_numeric_benchmark_results = Benchmark::fixed_point_throughput(100000, 60);
+            }
+
+            if (!m_numeric_benchmark_results.empty() && ImGui::BeginTable("NumericBenchmarkTable", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+            {
+                ImGui::TableSetupColumn("Type");
+                ImGui::TableSetupColumn("Time (ms)");
+                ImGui::TableSetupColumn("Relative");
+                ImGui::TableSetupColumn("Checksum");
+                ImGui::TableHeadersRow();
+
+                for (const auto &result : m_numeric_benchmark_results)
+                {
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::Text("%s", result.type);
+                    ImGui::TableSetColumnIndex(1);
+                    ImGui::Text("%.2f", result.milliseconds);
+                    ImGui::TableSetColumnIndex(2);
+                    ImGui::Text("%.2fx", result.milliseconds / m_numeric_benchmark_results.front().milliseconds);
+                    ImGui::TableSetColumnIndex(3);
+                    ImGui::Text("%016llx", static_cast<unsigned long long>(result.checksum));
+                }
+                ImGui::EndTable();
+            }
             ImGui::EndTabItem();
         }
 
@@ -810,7 +1296,7 @@ void ScenePlay::system_gui()
 
                     for (const auto &e : m_entities.get_entities())
                     {
-                        const auto &pos{e->get<CTransform>().pos};
+                        const auto pos{e.has<CTransform>() ? e.get<CTransform>().pos : sf::Vector2f{}};
                         const sf::Vector2i grid_pos{
                             static_cast<int>(pos.x) / static_cast<int>(m_grid_size.x),
                             (static_cast<int>(get_height()) - static_cast<int>(pos.y)) / static_cast<int>(m_grid_size.y)};
@@ -819,18 +1305,18 @@ void ScenePlay::system_gui()
                         ImGui::TableNextRow();
 
                         ImGui::TableSetColumnIndex(current_col++);
-                        ImGui::Text("%zu", e->id());
+                        ImGui::Text("%zu", e.id());
 
                         ImGui::TableSetColumnIndex(current_col++);
-                        ImGui::Text("%s", e->tag().c_str());
+                        ImGui::Text("%s", tag_name(e.tag()));
 
                         ImGui::TableSetColumnIndex(current_col++);
 
                         ImGui::Text("(%d, %d)", grid_pos.x, grid_pos.y);
                         ImGui::TableSetColumnIndex(current_col++);
-                        if (ImGui::Button(("Destroy##" + std::to_string(e->id())).c_str()))
+                        if (ImGui::Button(("Destroy##" + std::to_string(e.id())).c_str()))
                         {
-                            e->destroy();
+                            e.destroy();
                         }
                     }
                 }
@@ -838,11 +1324,17 @@ void ScenePlay::system_gui()
             }
 
             /* By Tag */
-            for (auto &[tag, entity_vec] : m_entities.get_entity_map())
+            for (size_t tag = 0; tag < tag_count; ++tag)
             {
-                if (ImGui::CollapsingHeader(tag.c_str()))
+                const auto &entity_vec{m_entities.get_entity_map()[tag]};
+                if (entity_vec.empty())
+                {
+                    continue;
+                }
+
+                if (ImGui::CollapsingHeader(tag_names[tag]))
                 {
-                    if (ImGui::BeginTable(tag.c_str(), 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+                    if (ImGui::BeginTable(tag_names[tag], 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
                     {
                         ImGui::TableSetupColumn("ID");
                         ImGui::TableSetupColumn("Tag");
@@ -852,7 +1344,7 @@ void ScenePlay::system_gui()
 
                         for (const auto &e : entity_vec)
                         {
-                            const auto &pos{e->get<CTransform>().pos};
+                            const auto pos{e.has<CTransform>() ? e.get<CTransform>().pos : sf::Vector2f{}};
                             const sf::Vector2i grid_pos{
                                 static_cast<int>(pos.x) / static_cast<int>(m_grid_size.x),
                                 (static_cast<int>(get_height()) - static_cast<int>(pos.y)) / static_cast<int>(m_grid_size.y)};
@@ -861,18 +1353,18 @@ void ScenePlay::system_gui()
                             ImGui::TableNextRow();
 
                             ImGui::TableSetColumnIndex(current_col++);
-                            ImGui::Text("%zu", e->id());
+                            ImGui::Text("%zu", e.id());
 
                             ImGui::TableSetColumnIndex(current_col++);
-                            ImGui::Text("%s", e->tag().c_str());
+                            ImGui::Text("%s", tag_name(e.tag()));
 
                             ImGui::TableSetColumnIndex(current_col++);
 
                             ImGui::Text("(%d, %d)", grid_pos.x, grid_pos.y);
                             ImGui::TableSetColumnIndex(current_col++);
-                            if (ImGui::Button(("Destroy##" + std::to_string(e->id())).c_str()))
+                            if (ImGui::Button(("Destroy##" + std::to_string(e.id())).c_str()))
                             {
-                                e->destroy();
+                                e.destroy();
                             }
                         }
                     }
@@ -893,26 +1385,20 @@ void ScenePlay::system_sound()
     if (!m_sound)
         return;
 
-    for (const auto &e : m_entities.get_entities())
+    for (const auto &e : m_entities.query<CSound>())
     {
-        if (!e->has<CSound>()) [[likely]]
-        {
-            continue;
-        }
-
-        auto &sound{e->get<CSound>()};
+        auto &sound{e.get<CSound>()};
 
         if (!sound.played)
         {
-            sound.sound->play();
+            sound.voice = m_sound_bank.play(*sound.buffer, sound.volume, sound.loop);
             sound.played = true;
         }
 
         /* Destroy entity when sound has ended (entities that have a sound component must be temporary entities) */
-        if (sound.played && !sound.loop && sound.sound->getStatus() == sf::Sound::Status::Stopped)
+        if (sound.played && !sound.loop && m_sound_bank.is_stopped(sound.voice))
         {
-            // e->remove<CSound>();
-            e->destroy();
+            m_sound_commands.destroy(e);
         }
     }
 }
@@ -928,8 +1414,12 @@ void ScenePlay::system_render()
     if (!m_render)
         return;
 
+    /* Positions are rendered between the last two ticks, a paused scene shows its current positions */
+    const float alpha{m_paused ? 1.0f : m_interpolation};
+
     /* Set viewport to be centered on the player if it's far enough right */
-    auto &player_pos{m_player->get<CTransform>().pos};
+    const auto &player_transform{m_player.get<CTransform>()};
+    const sf::Vector2f player_pos{player_transform.previous_pos + (player_transform.pos - player_transform.previous_pos) * alpha};
     float window_center_x{std::max(0.5f * static_cast<float>(m_game->get_window().getSize().x), player_pos.x)};
 
     sf::View view{m_game->get_window().getDefaultView()};
@@ -939,18 +1429,53 @@ void ScenePlay::system_render()
     /* Draw entity textures / animations */
     if (m_draw_textures)
     {
-        for (const auto &e : m_entities.get_entities())
+        const auto &transforms{m_entities.get_pool<CTransform>()};
+        auto &animations{m_entities.get_pool<CAnimation>()};
+        for (size_t i = 0; i < animations.size(); ++i)
         {
-            auto &transform{e->get<CTransform>()};
-            if (e->has<CAnimation>())
+            const size_t id{animations.entities()[i]};
+            if (!transforms.contains(id)) [[unlikely]]
             {
-                auto &anim{e->get<CAnimation>().animation};
-                anim.get_sprite().setRotation(sf::radians(transform.angle));
-                anim.get_sprite().setPosition(transform.pos);
-                anim.get_sprite().setScale(transform.scale);
-                m_game->get_window().draw(anim.get_sprite());
+                continue;
+            }
+
+            if (id >= m_sprites.size())
+            {
+                m_sprites.resize(id + 1);
+            }
+
+            const auto &anim{animations.components()[i]};
+            auto &sprite{m_sprites[id]};
+            const bool animation_changed{animations.ticks()[i] > m_render_tick};
+
+            /* New animation, the sprite is created again from its texture */
+            if (animation_changed || !sprite.has_value())
+            {
+                sprite.emplace(anim.animation->get_texture());
+                sprite->setOrigin(0.5f * static_cast<sf::Vector2f>(anim.animation->get_size()));
             }
+
+            /* Sprites keep their transform, only update it if the transform or the animation changed since the last render.
+               A transform changed during the last rendered tick is still moving between frames, until it reaches pos */
+            if (animation_changed || transforms.get_tick(id) >= m_render_tick)
+            {
+                const auto &transform{transforms.get(id)};
+                sprite->setRotation(sf::radians(transform.angle));
+                sprite->setPosition(transform.previous_pos + (transform.pos - transform.previous_pos) * alpha);
+                sprite->setScale(transform.scale);
+            }
+            sprite->setTextureRect(anim.animation->get_texture_rect(anim.current_frame));
+            m_draw_order.emplace_back(m_entities.get_entity(id).spawn_order(), static_cast<uint32_t>(id));
         }
+        m_render_tick = m_entities.get_tick();
+
+        /* Removals reorder the pools, sprites are sorted back to the order their entities were added in, later ones on top */
+        std::sort(m_draw_order.begin(), m_draw_order.end());
+        for (const auto &[spawn_order, id] : m_draw_order)
+        {
+            m_game->get_window().draw(m_sprites[id].value());
+        }
+        m_draw_order.clear();
     }
 
     /* Draw entity collision bounding boxes */
@@ -958,10 +1483,10 @@ void ScenePlay::system_render()
     {
         for (const auto &e : m_entities.get_entities())
         {
-            if (e->has<CBoundingBox>())
+            if (e.has<CBoundingBox>())
             {
-                auto &box{e->get<CBoundingBox>()};
-                auto &transform{e->get<CTransform>()};
+                auto &box{e.get<CBoundingBox>()};
+                auto &transform{e.get<CTransform>()};
                 sf::RectangleShape rect{};
                 rect.setSize(box.size - sf::Vector2f{1.0, 1.0});
                 rect.setOrigin(box.half_size);
@@ -972,10 +1497,10 @@ void ScenePlay::system_render()
                 m_game->get_window().draw(rect);
             }
 
-            if (e->has<CBoundingConvex>())
+            if (e.has<CBoundingConvex>())
             {
-                auto &conv{e->get<CBoundingConvex>()};
-                auto &transform{e->get<CTransform>()};
+                auto &conv{e.get<CBoundingConvex>()};
+                auto &transform{e.get<CTransform>()};
                 sf::ConvexShape shape{};
                 shape.setPointCount(conv.count);
                 for (size_t i = 0; i < conv.count; ++i)
@@ -989,6 +1514,27 @@ void ScenePlay::system_render()
                 m_game->get_window().draw(shape);
             }
         }
+
+        /* Merged colliders of the tile grid */
+        m_tile_grid.for_each_merged([this](const Physics::Aabb &bounds)
+                                    {
+                                        sf::RectangleShape rect{};
+                                        rect.setSize(bounds.max - bounds.min - sf::Vector2f{1.0, 1.0});
+                                        rect.setPosition(bounds.min);
+                                        rect.setFillColor({0, 0, 0, 0});
+                                        rect.setOutlineColor(sf::Color::Green);
+                                        rect.setOutlineThickness(1.0f);
+                                        m_game->get_window().draw(rect); });
+
+        /* Line of sight of the player, up to the first collider */
+        if (m_player.is_alive())
+        {
+            const auto &transform{m_player.get<CTransform>()};
+            const sf::Vector2f facing{transform.scale.x, 0.0f};
+            Physics::RayHit sight{};
+            const bool hit{m_world_query.raycast(transform.pos, facing, sight_distance, Physics::get_collision_filter(m_player), m_player, sight)};
+            draw_line(transform.pos, hit ? sight.point : transform.pos + facing * sight_distance);
+        }
     }
 
     /* Draw grid for debug */
@@ -1066,7 +1612,7 @@ void ScenePlay::system_do_action(const Action &action)
 
         else if (action.name == "JUMP")
         {
-            auto &input{m_player->get<CInput>()};
+            auto &input{m_player.get<CInput>()};
             if (input.can_jump)
             {
                 input.up = true;
@@ -1075,17 +1621,17 @@ void ScenePlay::system_do_action(const Action &action)
 
         else if (action.name == "LEFT")
         {
-            m_player->get<CInput>().left = true;
+            m_player.get<CInput>().left = true;
         }
 
         else if (action.name == "RIGHT")
         {
-            m_player->get<CInput>().right = true;
+            m_player.get<CInput>().right = true;
         }
 
         else if (action.name == "SHOOT")
         {
-            m_player->get<CInput>().shoot = true;
+            m_player.get<CInput>().shoot = true;
         }
     }
 
@@ -1093,33 +1639,35 @@ void ScenePlay::system_do_action(const Action &action)
     {
         if (action.name == "JUMP")
         {
-            m_player->get<CInput>().up = false;
+            m_player.get<CInput>().up = false;
         }
 
         else if (action.name == "LEFT")
         {
-            m_player->get<CInput>().left = false;
+            m_player.get<CInput>().left = false;
         }
 
         else if (action.name == "RIGHT")
         {
-            m_player->get<CInput>().right = false;
+            m_player.get<CInput>().right = false;
         }
 
         else if (action.name == "SHOOT")
         {
-            m_player->get<CInput>().shoot = false;
+            m_player.get<CInput>().shoot = false;
         }
     }
 }
 
 void ScenePlay::on_end()
 {
+    m_sound_bank.stop_all();
+
     /* Go back to menu scene */
     m_game->change_scene("MENU", std::make_shared<SceneMenu>(m_game), true);
 }
 
-void ScenePlay::change_player_state_to(CState &state, const std::string &new_state) noexcept
+void ScenePlay::change_player_state_to(CState &state, PlayerState new_state) noexcept
 {
     if (state.state != new_state)
     {
@@ -1133,42 +1681,74 @@ void ScenePlay::change_player_state_to(CState &state, const std::string &new_sta
     }
 }
 
-void ScenePlay::spawn_explosion(const std::shared_ptr<Entity> &tile)
+void ScenePlay::spawn_explosion(CommandBuffer &commands, Entity tile)
 {
-    tile->get<CAnimation>().animation = m_game->get_assets().get_animation("Explosion");
-    tile->get<CAnimation>().repeat = false;
-    tile->remove<CBoundingBox>();
-    spawn_sound("Explosion", tile->get<CTransform>().pos);
+    tile.get<CAnimation>() = CAnimation(m_game->get_assets().get_animation("Explosion"), false);
+    tile.mark_changed<CAnimation>();
+    m_tile_grid.remove(tile, Physics::get_bounds(tile));
+    m_static_bvh.remove(tile);
+    commands.remove<CBoundingBox>(tile);
+    spawn_sound(commands, "Explosion", tile.get<CTransform>().pos);
 }
 
-void ScenePlay::spawn_debris(const std::shared_ptr<Entity> &tile)
+void ScenePlay::spawn_debris(CommandBuffer &commands, Entity tile)
 {
-    tile->get<CAnimation>().animation = m_game->get_assets().get_animation("BrickDebris");
-    tile->get<CAnimation>().repeat = false;
-    tile->remove<CBoundingBox>();
-    spawn_sound("Debris", tile->get<CTransform>().pos);
+    tile.get<CAnimation>() = CAnimation(m_game->get_assets().get_animation("BrickDebris"), false);
+    tile.mark_changed<CAnimation>();
+    m_tile_grid.remove(tile, Physics::get_bounds(tile));
+    m_static_bvh.remove(tile);
+    commands.remove<CBoundingBox>(tile);
+    spawn_sound(commands, "Debris", tile.get<CTransform>().pos);
 }
 
-void ScenePlay::spawn_coin(const std::shared_ptr<Entity> &tile)
+void ScenePlay::spawn_coin(CommandBuffer &commands, Entity tile)
 {
     // Coin animation should not be repeated but it does not play correctly, so keep lifespan for now
-    auto coin{m_entities.add_entity("coin")};
-    coin->add<CAnimation>(m_game->get_assets().get_animation("CoinSpin"), true);
-    coin->add<CTransform>(tile->get<CTransform>().pos + sf::Vector2f{0.0f, -static_cast<float>(m_grid_size.y)});
-    coin->add<CLifeSpan>(30, m_current_frame);
-    spawn_sound("Coin", coin->get<CTransform>().pos);
+    const sf::Vector2f pos{tile.get<CTransform>().pos + sf::Vector2f{0.0f, -static_cast<float>(m_grid_size.y)}};
+    const auto coin{commands.spawn(Tag::Coin)};
+    commands.add<CAnimation>(coin, m_game->get_assets().get_animation("CoinSpin"), true);
+    commands.add<CTransform>(coin, pos);
+    commands.add<CLifeSpan>(coin, 30, m_current_frame);
+    commands.add<CCollisionFilter>(coin, get_collision_filter(Tag::Coin));
+    spawn_sound(commands, "Coin", pos);
+}
+
+void ScenePlay::spawn_sound(CommandBuffer &commands, const std::string &name, const sf::Vector2f &pos)
+{
+    const auto sound{commands.spawn(Tag::Sound)};
+    commands.add<CSound>(sound, m_game->get_assets().get_sound(name), false, m_game->settings.m_sound_volume);
+    commands.add<CTransform>(sound, pos);
 }
 
-void ScenePlay::spawn_sound(const std::string &name, const sf::Vector2f &pos)
+[[nodiscard]] TileType ScenePlay::get_tile_type(Entity entity) noexcept
 {
-    auto sound{m_entities.add_entity("sound")};
-    sound->add<CSound>(m_game->get_assets().get_sound(name), false, m_game->settings.m_sound_volume);
-    sound->add<CTransform>(pos);
+    if (entity.tag() == Tag::Spike)
+    {
+        return TileType::Spike;
+    }
+
+    const auto &name{entity.get<CAnimation>().animation->get_name()};
+    if (name == "Brick")
+    {
+        return TileType::Brick;
+    }
+    if (name == "Question")
+    {
+        return TileType::Question;
+    }
+    if (name == "Flagpole")
+    {
+        return TileType::Flagpole;
+    }
+    return TileType::Solid;
 }
 
 void ScenePlay::reset_player()
 {
-    auto &transform{m_player->get<CTransform>()};
+    auto &transform{m_player.get<CTransform>()};
     transform.pos = grid_to_mid_pixel(m_player_conf.x, m_player_conf.y, m_player);
+    transform.previous_pos = transform.pos; // Teleport, not interpolated
     transform.velocity = {0.0f, 0.0f};
+    m_player.get<CJump>().grounded = false; // The contacts are left behind, it must not rest before being tested
+    m_player.mark_changed<CTransform>();
 }
\ No newline at end of file
@@ -2,9 +2,19 @@
 
 #include "scene.hpp"
 #include "config_structs.hpp"
+#include "command_buffer.hpp"
+#include "system_scheduler.hpp"
+#include "benchmark.hpp"
+#include "sweep_and_prune.hpp"
+#include "tile_grid.hpp"
+#include "static_bvh.hpp"
+#include "physics_batch.hpp"
+#include "physics_query.hpp"
+#include "contact_queue.hpp"
 #include <SFML/Audio/Sound.hpp>
 #include <SFML/Graphics/Font.hpp>
 #include <SFML/Graphics/Text.hpp>
+#include <SFML/Graphics/Sprite.hpp>
 
 /**
  * @brief Represents the main gameplay scene.
@@ -37,10 +47,15 @@ public:
     explicit ScenePlay(GameEngine *game, const std::string &level_path);
 
     /**
-     * @brief Update the scene
+     * @brief Update the scene by one fixed tick
      */
     void update() override;
 
+    /**
+     * @brief Draw the scene and its GUI, with positions interpolated between the last two ticks
+     */
+    void render() override;
+
 private:
     /**
      * @brief Initialize the scene using the given level data file
@@ -57,7 +72,25 @@ private:
      * @param entity Entity you want to find the center position of
      */
     [[nodiscard]]
-    sf::Vector2f grid_to_mid_pixel(float grid_x, float grid_y, const std::shared_ptr<Entity> &entity) noexcept;
+    sf::Vector2f grid_to_mid_pixel(float grid_x, float grid_y, Entity entity) noexcept;
+
+    /**
+     * @brief Register the systems in the scheduler, with the components they read and write
+     */
+    void init_systems();
+
+    /**
+     * @brief Build the collision filter of each tag from the collision section of the config
+     */
+    void load_collision_filters();
+
+    /**
+     * @brief Return the collision filter of the entities of a tag
+     *
+     * @param tag Tag
+     */
+    [[nodiscard]]
+    const CCollisionFilter &get_collision_filter(Tag tag) const noexcept;
 
     /**
      * @brief Load a level using a data file
@@ -74,9 +107,10 @@ private:
     /**
      * @brief Add a bullet to the scene
      *
+     * @param commands Buffer recording the spawn
      * @param entity Bullet will spawn from this entity's position
      */
-    void spawn_bullet(const std::shared_ptr<Entity> &entity);
+    void spawn_bullet(CommandBuffer &commands, Entity entity);
 
     /**
      * @brief Handle player inputs
@@ -93,6 +127,58 @@ private:
      */
     void system_collision();
 
+    /**
+     * @brief Contact found by the parallel narrowphase, reported once the threads are done
+     */
+    struct PendingContact
+    {
+        Entity a{};
+        Entity b{};
+        sf::Vector2f normal{};
+        float penetration{};
+        sf::Vector2f velocity{}; // Of the bullet, tiles do not move
+    };
+
+    /**
+     * @brief Memory of a chunk of the parallel narrowphase, only used by the thread running the chunk
+     */
+    struct NarrowphaseBuffer
+    {
+        EntityVec candidates{};
+        std::vector<uint32_t> merged_candidates{};
+        Physics::BoxBatch boxes{};
+        std::vector<Physics::BoxHit> hits{};
+        std::vector<PendingContact> contacts{};
+    };
+
+    /**
+     * @brief Find the tiles hit by a bullet, safe to call from several threads with different buffers
+     *
+     * @param bullet Bullet
+     * @param buffer Memory of the chunk, contacts are appended to it
+     */
+    void find_bullet_contacts(Entity bullet, NarrowphaseBuffer &buffer) const;
+
+    /**
+     * @brief Run the gameplay reactions to the contact events of the collision system
+     */
+    void handle_contacts();
+
+    /**
+     * @brief A bullet hitting a tile is destroyed, and destroys the tile if it's a brick tile
+     *
+     * @param event Contact, a is the bullet
+     * @param first_contact True for the first contact of the bullet in this pass, the bullet is only counted once
+     */
+    void handle_bullet_contact(const ContactEvent &event, bool first_contact);
+
+    /**
+     * @brief Player landing on the flagpole, hitting a brick or a question block from below, or a spike
+     *
+     * @param event Contact, a is the player
+     */
+    void handle_player_contact(const ContactEvent &event);
+
     /**
      * @brief Handle animations of entities
      */
@@ -118,6 +204,11 @@ private:
      */
     void system_do_action(const Action &action) override;
 
+    /**
+     * @brief Apply the structural changes recorded by the systems, in the order the systems ran
+     */
+    void flush_commands();
+
     /**
      * @brief Handle the scene exit
      */
@@ -129,38 +220,50 @@ private:
      * @param state Player's state component
      * @param new_state New player's state
      */
-    void change_player_state_to(CState &state, const std::string &new_state) noexcept;
+    void change_player_state_to(CState &state, PlayerState new_state) noexcept;
 
     /**
      * @brief Change the tile animation to an explosion, and add a timer before removing it. 
      * Use this when a brick is destroyed via a bullet
      * 
+     * @param commands Buffer recording the structural changes
      * @param tile Brick tile to update
      */
-    void spawn_explosion(const std::shared_ptr<Entity> &tile);
+    void spawn_explosion(CommandBuffer &commands, Entity tile);
 
     /**
      * @brief Change the tile animation to debris, and add a timer before removing it. 
      * Use this when a brick is destroyed via the player collision
      * 
+     * @param commands Buffer recording the structural changes
      * @param tile Brick tile to update
      */
-    void spawn_debris(const std::shared_ptr<Entity> &tile);
+    void spawn_debris(CommandBuffer &commands, Entity tile);
 
     /**
      * @brief Spawn a spinning coin over a question mark tile
      * 
+     * @param commands Buffer recording the spawn
      * @param tile Question mark tile
      */
-    void spawn_coin(const std::shared_ptr<Entity> &tile);
+    void spawn_coin(CommandBuffer &commands, Entity tile);
 
     /**
      * @brief Spawn an entity that will play the given sound at the given position
      * 
+     * @param commands Buffer recording the spawn
      * @param name Sound's name
      * @param pos Position
      */
-    void spawn_sound(const std::string &name, const sf::Vector2f &pos);
+    void spawn_sound(CommandBuffer &commands, const std::string &name, const sf::Vector2f &pos);
+
+    /**
+     * @brief Return the type of a static collider, from its tag and animation
+     *
+     * @param entity Tile or spike
+     */
+    [[nodiscard]]
+    static TileType get_tile_type(Entity entity) noexcept;
 
     /**
      * @brief Respawn player at its initial position
@@ -169,7 +272,7 @@ private:
     void reset_player();
 
 private:
-    std::shared_ptr<Entity> m_player{};
+    Entity m_player{};
     std::string m_level_path{};
     const sf::Vector2u m_grid_size{64, 64};
     sf::Font m_font{};
@@ -190,6 +293,63 @@ private:
     bool m_action{true};
     bool m_sound{true};
 
+    /* Systems run on the job system of the engine, ranges bigger than the grain are split between threads */
+    static constexpr size_t parallel_grain{1024};
+    SystemScheduler m_scheduler{};
+
+    /* Voices playing the sounds of the sound components */
+    SoundBank m_sound_bank{};
+
+    /* Sprite of each entity that has an animation, indexed by entity id, kept between frames */
+    std::vector<std::optional<sf::Sprite>> m_sprites{};
+    std::vector<std::pair<uint64_t, uint32_t>> m_draw_order{}; // Spawn order and id of the entities drawn this frame
+
+    /* Broadphase of the collision system for moving entities */
+    SweepAndPrune m_sweep{};
+    EntityVec m_candidates{}; // Result of the last broadphase query, kept to reuse its memory
+    std::vector<uint32_t> m_merged_candidates{}; // Merged rectangles of the tile grid around the entity
+    Physics::BoxBatch m_candidate_boxes{};
+    std::vector<Physics::BoxHit> m_hits{};
+
+    /* Bullets are tested in parallel by chunks, each chunk has its own buffer, kept between frames */
+    static constexpr size_t narrowphase_grain{32};
+    std::vector<NarrowphaseBuffer> m_narrowphase_buffers{};
+    std::vector<PendingContact> m_bullet_contacts{};
+
+    /* Contacts of the collision system, consumed by the gameplay handlers */
+    static constexpr size_t contact_capacity{1024};
+    ContactQueue m_contacts{contact_capacity};
+
+    /* Collision filter given to the entities of each tag, from the config, tags missing from it collide with everything */
+    std::array<CCollisionFilter, tag_count> m_collision_filters; // Default constructed, the constructor is explicit
+
+    /* Tiles of the level on their grid cells, for constant time lookup of the tiles around an entity */
+    TileGrid m_tile_grid{static_cast<sf::Vector2f>(m_grid_size)};
+
+    /* Every static collider of the level, whatever its size, for the scene queries */
+    StaticBvh m_static_bvh{};
+
+    /* Raycasts and box queries over the static colliders and the sweep, for the debug probes of the player */
+    static constexpr float ground_probe_distance{4.0f};
+    static constexpr float sight_distance{512.0f};
+    Physics::WorldQuery m_world_query{m_static_bvh, m_sweep};
+
+    /* Tick of the last pass of systems that skip unchanged components */
+    uint32_t m_collision_tick{};
+    uint32_t m_render_tick{};
+
+    /* Job system benchmark results */
+    std::vector<Benchmark::Result> m_benchmark_results{};
+    std::vector<Benchmark::QueryResult> m_query_benchmark_results{};
+    std::vector<Benchmark::NumericResult> m_numeric_benchmark_results{};
+
+    /* Structural changes recorded by each system, applied at the end of the frame */
+    CommandBuffer m_movement_commands{};
+    CommandBuffer m_sound_commands{};
+    CommandBuffer m_lifespan_commands{};
+    CommandBuffer m_collision_commands{};
+    CommandBuffer m_animation_commands{};
+
     /* Count bullets to know when player can shoot */
     size_t m_bullet_count{};
 
@@ -0,0 +1,47 @@
+#include "sound_bank.hpp"
+
+SoundBank::SoundBank(size_t voice_count) : m_voices(voice_count)
+{
+}
+
+SoundHandle SoundBank::play(const sf::SoundBuffer &buffer, float volume, bool loop)
+{
+    for (uint32_t i = 0; i < m_voices.size(); ++i)
+    {
+        auto &voice{m_voices[i]};
+        if (voice.sound.has_value() && voice.sound->getStatus() != sf::Sound::Status::Stopped)
+        {
+            continue;
+        }
+
+        voice.sound.emplace(buffer);
+        voice.sound->setLooping(loop);
+        voice.sound->setVolume(volume);
+        voice.sound->play();
+        voice.generation++;
+        return SoundHandle{i, voice.generation};
+    }
+    return SoundHandle{};
+}
+
+[[nodiscard]] bool SoundBank::is_stopped(SoundHandle handle) const noexcept
+{
+    if (handle.index >= m_voices.size())
+    {
+        return true;
+    }
+
+    const auto &voice{m_voices[handle.index]};
+    return voice.generation != handle.generation || !voice.sound.has_value() || voice.sound->getStatus() == sf::Sound::Status::Stopped;
+}
+
+void SoundBank::stop_all() noexcept
+{
+    for (auto &voice : m_voices)
+    {
+        if (voice.sound.has_value())
+        {
+            voice.sound->stop();
+        }
+    }
+}
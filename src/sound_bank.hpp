@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+#include <optional>
+#include <cstdint>
+#include <limits>
+#include <SFML/Audio/Sound.hpp>
+#include <SFML/Audio/SoundBuffer.hpp>
+
+/**
+ * @brief Handle to a voice of a SoundBank
+ *
+ * The generation is increased each time the voice is reused, so an old handle is seen as stopped.
+ */
+struct SoundHandle
+{
+    uint32_t index{std::numeric_limits<uint32_t>::max()};
+    uint32_t generation{};
+};
+
+/**
+ * @brief Fixed number of voices playing sounds for a scene.
+ *
+ * Components only store a SoundHandle, the sf::Sound objects live in the bank,
+ * so sound components stay plain data.
+ *
+ * Usage:
+ *
+ * - play(buffer, volume, loop): Play a sound on a free voice, return its handle
+ *
+ * - is_stopped(handle): Check if the sound of the handle has ended
+ *
+ * - stop_all(): Stop every voice
+ *
+ * @note If every voice is busy, the sound is not played and an invalid handle is returned
+ */
+class SoundBank
+{
+public:
+    /**
+     * @brief Create a bank with the given number of voices
+     *
+     * @param voice_count Maximum number of sounds playing at the same time
+     */
+    explicit SoundBank(size_t voice_count = 32);
+
+    /**
+     * @brief Play a sound on a free voice
+     *
+     * @param buffer Sound buffer, must outlive the sound
+     * @param volume Volume
+     * @param loop True if the sound loops
+     *
+     * @return Handle of the voice, invalid if every voice is busy
+     */
+    SoundHandle play(const sf::SoundBuffer &buffer, float volume, bool loop);
+
+    /**
+     * @brief Check if the sound of the handle is not playing anymore
+     *
+     * @param handle Voice handle
+     */
+    [[nodiscard]]
+    bool is_stopped(SoundHandle handle) const noexcept;
+
+    /**
+     * @brief Stop every voice
+     */
+    void stop_all() noexcept;
+
+private:
+    /**
+     * @brief Voice slot
+     */
+    struct Voice
+    {
+        std::optional<sf::Sound> sound{};
+        uint32_t generation{};
+    };
+
+    std::vector<Voice> m_voices{};
+};
@@ -0,0 +1,307 @@
+#include "static_bvh.hpp"
+#include <array>
+#include <algorithm>
+
+////////////////////////////////////////// HELPER FUNCTIONS //////////////////////////////////////////
+
+/**
+ * @brief Bounds that contain nothing, merging them with other bounds gives the other bounds
+ */
+static constexpr Physics::Aabb empty_bounds{sf::Vector2f{std::numeric_limits<float>::max(), std::numeric_limits<float>::max()},
+                                            sf::Vector2f{std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()}};
+
+/**
+ * @brief Smallest bounds holding both bounds
+ */
+[[nodiscard]]
+static Physics::Aabb merge(const Physics::Aabb &a, const Physics::Aabb &b) noexcept
+{
+    return Physics::Aabb{sf::Vector2f{std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y)},
+                         sf::Vector2f{std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y)}};
+}
+
+/**
+ * @brief Return true if the bounds hold nothing, like the bounds of a leaf whose colliders were all removed
+ */
+[[nodiscard]]
+static bool is_empty(const Physics::Aabb &bounds) noexcept
+{
+    return bounds.min.x > bounds.max.x || bounds.min.y > bounds.max.y;
+}
+
+/**
+ * @brief Center of bounds on an axis, 0 for x and 1 for y
+ */
+[[nodiscard]]
+static float get_center(const Physics::Aabb &bounds, size_t axis) noexcept
+{
+    return axis == 0 ? bounds.min.x + bounds.max.x : bounds.min.y + bounds.max.y; // Twice the center, only compared
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void StaticBvh::build(std::span<const Collider> colliders)
+{
+    const Stats previous{m_stats};
+    m_nodes.clear();
+    m_parents.clear();
+    m_colliders.assign(colliders.begin(), colliders.end());
+    m_leaf_of_collider.assign(m_colliders.size(), no_node);
+    m_stats = Stats{};
+    m_stats.refits = previous.refits;
+    m_stats.rebuilds = previous.rebuilds;
+
+    if (!m_colliders.empty())
+    {
+        /* A binary tree with leaves of at most max_leaf_size colliders, with a margin for uneven leaves */
+        m_nodes.reserve(4 * (m_colliders.size() / max_leaf_size + 1));
+        m_parents.reserve(m_nodes.capacity());
+        m_nodes.emplace_back();
+        m_parents.push_back(no_node);
+        build_node(0, 0, static_cast<uint32_t>(m_colliders.size()), 0);
+    }
+
+    /* Colliders moved while building, find them by entity id */
+    m_collider_of_entity.clear();
+    for (uint32_t i = 0; i < m_colliders.size(); ++i)
+    {
+        const size_t id{m_colliders[i].entity.id()};
+        if (id >= m_collider_of_entity.size())
+        {
+            m_collider_of_entity.resize(id + 1, no_node);
+        }
+        m_collider_of_entity[id] = i;
+    }
+
+    m_stats.colliders = m_colliders.size();
+    m_stats.nodes = m_nodes.size();
+    m_stats.memory_bytes = m_nodes.size() * (sizeof(Node) + sizeof(uint32_t)) + m_colliders.size() * (sizeof(Collider) + sizeof(uint32_t)) +
+                           m_collider_of_entity.size() * sizeof(uint32_t);
+}
+
+bool StaticBvh::remove(const Entity &entity)
+{
+    if (entity.id() >= m_collider_of_entity.size())
+    {
+        return false;
+    }
+
+    const uint32_t index{m_collider_of_entity[entity.id()]};
+    if (index == no_node || m_colliders[index].entity != entity)
+    {
+        return false;
+    }
+
+    m_colliders[index].entity = Entity{};
+    m_collider_of_entity[entity.id()] = no_node;
+    m_stats.removed++;
+
+    /* Many refits leave loose nodes, rebuild once a quarter of the colliders are gone */
+    if (m_stats.removed * 4 > m_stats.colliders)
+    {
+        rebuild();
+        return true;
+    }
+
+    /* Shrink the nodes above the leaf, until one keeps its bounds */
+    m_stats.refits++;
+    for (uint32_t node = m_leaf_of_collider[index]; node != no_node && refit_node(node); node = m_parents[node])
+    {
+    }
+    return true;
+}
+
+void StaticBvh::clear() noexcept
+{
+    m_nodes.clear();
+    m_parents.clear();
+    m_colliders.clear();
+    m_leaf_of_collider.clear();
+    m_collider_of_entity.clear();
+    m_stats = Stats{};
+}
+
+void StaticBvh::query(const Physics::Aabb &bounds, const CCollisionFilter &filter, EntityVec &out) const
+{
+    if (m_nodes.empty())
+    {
+        return;
+    }
+
+    std::array<uint32_t, max_depth> stack{};
+    size_t size{0};
+    stack[size++] = 0;
+    while (size > 0)
+    {
+        const auto &node{m_nodes[stack[--size]]};
+        if (!Physics::overlaps(bounds, node.bounds))
+        {
+            continue;
+        }
+
+        if (node.count == 0)
+        {
+            stack[size++] = node.first;
+            stack[size++] = node.first + 1;
+            continue;
+        }
+
+        for (uint32_t i = node.first; i < node.first + node.count; ++i)
+        {
+            const auto &collider{m_colliders[i]};
+            if (is_reported(collider, filter) && Physics::overlaps(bounds, collider.bounds))
+            {
+                out.push_back(collider.entity);
+            }
+        }
+    }
+}
+
+[[nodiscard]] bool StaticBvh::raycast(const sf::Vector2f &origin, const sf::Vector2f &direction, float max_distance,
+                                      const CCollisionFilter &filter, const Entity &ignore, Physics::RayHit &hit) const
+{
+    if (m_nodes.empty())
+    {
+        return false;
+    }
+
+    bool found{false};
+    float best{max_distance};
+    float distance{};
+    sf::Vector2f normal{};
+
+    std::array<uint32_t, max_depth> stack{};
+    size_t size{0};
+    stack[size++] = 0;
+    while (size > 0)
+    {
+        /* The ray is shortened to the closest hit so far, farther nodes are skipped */
+        const auto &node{m_nodes[stack[--size]]};
+        if (is_empty(node.bounds) || !Physics::raycast_bounds(origin, direction, best, node.bounds, distance, normal))
+        {
+            continue;
+        }
+
+        if (node.count == 0)
+        {
+            /* Visit the child the ray enters first before the other one */
+            float left{};
+            float right{};
+            const auto &left_bounds{m_nodes[node.first].bounds};
+            const auto &right_bounds{m_nodes[node.first + 1].bounds};
+            const bool hit_left{!is_empty(left_bounds) && Physics::raycast_bounds(origin, direction, best, left_bounds, left, normal)};
+            const bool hit_right{!is_empty(right_bounds) && Physics::raycast_bounds(origin, direction, best, right_bounds, right, normal)};
+            if (hit_left && hit_right)
+            {
+                stack[size++] = left < right ? node.first + 1 : node.first;
+                stack[size++] = left < right ? node.first : node.first + 1;
+            }
+            else if (hit_left || hit_right)
+            {
+                stack[size++] = hit_left ? node.first : node.first + 1;
+            }
+            continue;
+        }
+
+        for (uint32_t i = node.first; i < node.first + node.count; ++i)
+        {
+            const auto &collider{m_colliders[i]};
+            if (collider.entity != ignore && is_reported(collider, filter) && Physics::raycast_bounds(origin, direction, best, collider.bounds, distance, normal) &&
+                (!found || distance < best))
+            {
+                hit = Physics::RayHit{collider.entity, origin + direction * distance, normal, distance};
+                best = distance;
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
+[[nodiscard]] const StaticBvh::Stats &StaticBvh::get_stats() const noexcept
+{
+    return m_stats;
+}
+
+void StaticBvh::build_node(uint32_t node, uint32_t first, uint32_t count, size_t depth)
+{
+    m_stats.depth = std::max(m_stats.depth, depth + 1);
+
+    Physics::Aabb bounds{empty_bounds};
+    Physics::Aabb centers{empty_bounds};
+    for (uint32_t i = first; i < first + count; ++i)
+    {
+        const auto &collider_bounds{m_colliders[i].bounds};
+        bounds = merge(bounds, collider_bounds);
+        const sf::Vector2f center{get_center(collider_bounds, 0), get_center(collider_bounds, 1)};
+        centers = merge(centers, Physics::Aabb{center, center});
+    }
+
+    /* The traversal stack holds one node per level, deeper trees are cut into bigger leaves */
+    if (count <= max_leaf_size || depth + 2 >= max_depth)
+    {
+        m_nodes[node] = Node{bounds, first, count};
+        for (uint32_t i = first; i < first + count; ++i)
+        {
+            m_leaf_of_collider[i] = node;
+        }
+        m_stats.leaves++;
+        return;
+    }
+
+    /* Median split on the axis where the centers spread the most */
+    const size_t axis{centers.max.x - centers.min.x >= centers.max.y - centers.min.y ? 0u : 1u};
+    const uint32_t half{count / 2};
+    std::nth_element(m_colliders.begin() + first, m_colliders.begin() + first + half, m_colliders.begin() + first + count,
+                     [axis](const Collider &lhs, const Collider &rhs)
+                     { return get_center(lhs.bounds, axis) < get_center(rhs.bounds, axis); });
+
+    const auto left{static_cast<uint32_t>(m_nodes.size())};
+    m_nodes.resize(m_nodes.size() + 2);
+    m_parents.push_back(node);
+    m_parents.push_back(node);
+    m_nodes[node] = Node{bounds, left, 0};
+
+    build_node(left, first, half, depth + 1);
+    build_node(left + 1, first + half, count - half, depth + 1);
+}
+
+bool StaticBvh::refit_node(uint32_t node) noexcept
+{
+    auto &current{m_nodes[node]};
+    Physics::Aabb bounds{empty_bounds};
+    if (current.count == 0)
+    {
+        bounds = merge(m_nodes[current.first].bounds, m_nodes[current.first + 1].bounds);
+    }
+    else
+    {
+        for (uint32_t i = current.first; i < current.first + current.count; ++i)
+        {
+            if (m_colliders[i].entity.is_valid())
+            {
+                bounds = merge(bounds, m_colliders[i].bounds);
+            }
+        }
+    }
+
+    const bool changed{bounds.min != current.bounds.min || bounds.max != current.bounds.max};
+    current.bounds = bounds;
+    return changed;
+}
+
+void StaticBvh::rebuild()
+{
+    std::vector<Collider> remaining{};
+    remaining.reserve(m_colliders.size() - m_stats.removed);
+    std::copy_if(m_colliders.begin(), m_colliders.end(), std::back_inserter(remaining), [](const Collider &collider)
+                 { return collider.entity.is_valid(); });
+
+    m_stats.rebuilds++;
+    build(remaining);
+}
+
+[[nodiscard]] bool StaticBvh::is_reported(const Collider &collider, const CCollisionFilter &filter) noexcept
+{
+    return Physics::can_collide(filter, collider.filter) && collider.entity.is_alive();
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include "physics.hpp"
+
+/**
+ * @brief Bounding volume hierarchy over the static colliders of a level, built once when the level is loaded.
+ *
+ * Unlike the TileGrid, its memory grows with the number of colliders and not with the area of the level,
+ * and it stores colliders of any size and shape (BoundingBox or BoundingConvex bounds).
+ *
+ * Nodes are stored in a flat array: the children of a node are next to each other, the left one first,
+ * and a leaf holds a range of the collider array, which is sorted so that each leaf range is contiguous.
+ * The tree is built top-down, splitting each node at the median of the centers of its colliders, on the longest axis.
+ *
+ * Removing a collider refits the bounds of its leaf and of the nodes above it. Once too many colliders are removed,
+ * the tree is rebuilt from the remaining ones.
+ *
+ * Usage:
+ *
+ * - build(colliders): Replace the content of the tree
+ *
+ * - remove(entity): Remove the collider of an entity, when a brick is destroyed
+ *
+ * - query(bounds, filter, out): Append the colliders overlapping the bounds
+ *
+ * - raycast(origin, direction, max_distance, filter, ignore, hit): Find the closest collider hit by a ray, skipping one entity
+ *
+ * - get_stats(): Size of the tree and number of refits and rebuilds
+ */
+class StaticBvh
+{
+public:
+    /**
+     * @brief Static collider to store in the tree
+     */
+    struct Collider
+    {
+        Entity entity{};
+        Physics::Aabb bounds{};
+        CCollisionFilter filter{};
+    };
+
+    /**
+     * @brief Size of the tree, and updates since the last build
+     */
+    struct Stats
+    {
+        size_t colliders{};    // Colliders in the tree, removed ones included until the next rebuild
+        size_t removed{};      // Colliders removed since the last rebuild
+        size_t nodes{};
+        size_t leaves{};
+        size_t depth{};
+        size_t memory_bytes{}; // Nodes and colliders
+        size_t refits{};
+        size_t rebuilds{};
+    };
+
+    /**
+     * @brief Default constructor
+     */
+    explicit StaticBvh() noexcept = default;
+
+    /**
+     * @brief Replace the content of the tree with the given colliders
+     *
+     * @param colliders Static colliders of the level
+     */
+    void build(std::span<const Collider> colliders);
+
+    /**
+     * @brief Remove the collider of an entity, refit the nodes above it or rebuild the tree
+     *
+     * @param entity Entity
+     *
+     * @return False if the entity has no collider in the tree
+     */
+    bool remove(const Entity &entity);
+
+    /**
+     * @brief Remove every collider
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Append the alive colliders overlapping the bounds and accepted by the filter
+     *
+     * @param bounds World bounds
+     * @param filter Collision filter of the query
+     * @param out Entities
+     */
+    void query(const Physics::Aabb &bounds, const CCollisionFilter &filter, EntityVec &out) const;
+
+    /**
+     * @brief Find the closest alive collider hit by a ray, nodes are visited near child first
+     *
+     * @param origin Start of the ray
+     * @param direction Unit direction of the ray
+     * @param max_distance Length of the ray
+     * @param filter Collision filter of the query
+     * @param ignore Entity skipped by the ray, the colliders behind it can be hit
+     * @param hit Closest collider hit
+     *
+     * @return True if a collider is hit
+     */
+    [[nodiscard]]
+    bool raycast(const sf::Vector2f &origin, const sf::Vector2f &direction, float max_distance, const CCollisionFilter &filter,
+                 const Entity &ignore, Physics::RayHit &hit) const;
+
+    /**
+     * @brief Return the size of the tree and the updates since the last build
+     */
+    [[nodiscard]]
+    const Stats &get_stats() const noexcept;
+
+private:
+    /**
+     * @brief Node of the tree, 24 bytes
+     */
+    struct Node
+    {
+        Physics::Aabb bounds{};
+        uint32_t first{}; // Leaf: first collider, internal node: left child, the right child follows it
+        uint32_t count{}; // Number of colliders of a leaf, 0 for an internal node
+    };
+
+    static constexpr uint32_t max_leaf_size{4};
+    static constexpr size_t max_depth{64}; // Size of the traversal stack, a median split never goes that deep
+    static constexpr uint32_t no_node{std::numeric_limits<uint32_t>::max()};
+
+    /**
+     * @brief Build the subtree of a node over a range of colliders
+     */
+    void build_node(uint32_t node, uint32_t first, uint32_t count, size_t depth);
+
+    /**
+     * @brief Recompute the bounds of a node from its colliders or children
+     *
+     * @return True if the bounds changed
+     */
+    bool refit_node(uint32_t node) noexcept;
+
+    /**
+     * @brief Rebuild the tree from the colliders that were not removed
+     */
+    void rebuild();
+
+    /**
+     * @brief Return true if the collider is still in the tree and can be reported
+     */
+    [[nodiscard]]
+    static bool is_reported(const Collider &collider, const CCollisionFilter &filter) noexcept;
+
+private:
+    std::vector<Node> m_nodes{};                   // Root first
+    std::vector<uint32_t> m_parents{};             // Parent of each node, no_node for the root
+    std::vector<Collider> m_colliders{};           // Sorted by leaf, removed colliders have an empty entity
+    std::vector<uint32_t> m_leaf_of_collider{};
+    std::vector<uint32_t> m_collider_of_entity{};  // Indexed by entity id
+    Stats m_stats{};
+};
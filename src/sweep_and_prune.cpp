@@ -0,0 +1,242 @@
+#include "sweep_and_prune.hpp"
+
+void SweepAndPrune::insert_static(Entity entity, const Physics::Aabb &bounds, const CCollisionFilter &filter)
+{
+    insert(entity, bounds, filter, false);
+}
+
+void SweepAndPrune::update_dynamic(Entity entity, const Physics::Aabb &bounds, const CCollisionFilter &filter)
+{
+    auto &body{m_bodies[insert(entity, bounds, filter, true)]};
+    body.bounds = bounds;
+    body.filter = filter;
+    body.updated = true;
+}
+
+void SweepAndPrune::update()
+{
+    m_stats = Stats{};
+
+    /* Remove dead bodies, and dynamic bodies that were not updated since the last frame */
+    bool any_removed{false};
+    for (uint32_t i = 0; i < m_bodies.size(); ++i)
+    {
+        auto &body{m_bodies[i]};
+        if (body.removed)
+        {
+            continue;
+        }
+
+        if ((body.dynamic && !body.updated) || !body.entity.is_alive())
+        {
+            body.removed = true;
+            m_body_of_entity[body.entity.id()] = no_body;
+            m_free_bodies.push_back(i);
+            any_removed = true;
+        }
+        else
+        {
+            m_stats.bodies++;
+            m_stats.dynamic_bodies += body.dynamic ? 1 : 0;
+        }
+        body.updated = false;
+    }
+
+    if (any_removed)
+    {
+        std::erase_if(m_endpoints, [this](const Endpoint &endpoint)
+                      { return m_bodies[endpoint.body].removed; });
+    }
+
+    /* Refresh the values, then sort: the order of the last frame is almost right */
+    for (auto &endpoint : m_endpoints)
+    {
+        const auto &bounds{m_bodies[endpoint.body].bounds};
+        endpoint.value = endpoint.is_min ? bounds.min.x : bounds.max.x;
+    }
+
+    for (size_t i = 1; i < m_endpoints.size(); ++i)
+    {
+        const Endpoint endpoint{m_endpoints[i]};
+        size_t j{i};
+        while (j > 0 && less(endpoint, m_endpoints[j - 1]))
+        {
+            m_endpoints[j] = m_endpoints[j - 1];
+            j--;
+            m_stats.swaps++;
+        }
+        m_endpoints[j] = endpoint;
+    }
+
+    /* Sweep: bodies open when a body starts overlap it on x */
+    m_pairs.clear();
+    m_active.clear();
+    for (const auto &endpoint : m_endpoints)
+    {
+        if (!endpoint.is_min)
+        {
+            const auto it{std::find(m_active.begin(), m_active.end(), endpoint.body)};
+            *it = m_active.back();
+            m_active.pop_back();
+            continue;
+        }
+
+        const auto &body{m_bodies[endpoint.body]};
+        for (const auto other_index : m_active)
+        {
+            const auto &other{m_bodies[other_index]};
+            if (!body.dynamic && !other.dynamic)
+            {
+                continue;
+            }
+
+            /* Bodies that can never interact are rejected before any bounds test */
+            if (!Physics::can_collide(body.filter, other.filter))
+            {
+                m_stats.filtered++;
+                continue;
+            }
+
+            m_stats.tests++;
+            if (body.bounds.min.y < other.bounds.max.y && other.bounds.min.y < body.bounds.max.y)
+            {
+                const bool ordered{body.entity.id() < other.entity.id()};
+                m_pairs.push_back(Pair{ordered ? body.entity : other.entity, ordered ? other.entity : body.entity});
+            }
+        }
+        m_active.push_back(endpoint.body);
+    }
+
+    m_stats.pairs = m_pairs.size();
+
+    /* Bucket the partners of each body (counting sort on the body index), in the order of the pairs */
+    m_partner_offsets.assign(m_bodies.size() + 1, 0);
+    for (const auto &pair : m_pairs)
+    {
+        m_partner_offsets[m_body_of_entity[pair.a.id()] + 1]++;
+        m_partner_offsets[m_body_of_entity[pair.b.id()] + 1]++;
+    }
+    for (size_t i = 1; i < m_partner_offsets.size(); ++i)
+    {
+        m_partner_offsets[i] += m_partner_offsets[i - 1];
+    }
+
+    m_partners.resize(2 * m_pairs.size());
+    m_active.assign(m_partner_offsets.begin(), m_partner_offsets.end() - 1); // Next free slot of each body
+    for (const auto &pair : m_pairs)
+    {
+        m_partners[m_active[m_body_of_entity[pair.a.id()]]++] = pair.b;
+        m_partners[m_active[m_body_of_entity[pair.b.id()]]++] = pair.a;
+    }
+    m_active.clear();
+}
+
+void SweepAndPrune::clear() noexcept
+{
+    m_bodies.clear();
+    m_free_bodies.clear();
+    m_body_of_entity.clear();
+    m_endpoints.clear();
+    m_active.clear();
+    m_pairs.clear();
+    m_partner_offsets.clear();
+    m_partners.clear();
+    m_stats = Stats{};
+}
+
+[[nodiscard]] const std::vector<SweepAndPrune::Pair> &SweepAndPrune::get_pairs() const noexcept
+{
+    return m_pairs;
+}
+
+void SweepAndPrune::get_partners(const Entity &entity, EntityVec &out) const
+{
+    if (entity.id() >= m_body_of_entity.size())
+    {
+        return;
+    }
+
+    /* Bodies added since the last update have no partners yet */
+    const uint32_t body{m_body_of_entity[entity.id()]};
+    if (body == no_body || body + 1 >= m_partner_offsets.size() || m_bodies[body].entity != entity)
+    {
+        return;
+    }
+
+    out.insert(out.end(), m_partners.begin() + static_cast<std::ptrdiff_t>(m_partner_offsets[body]),
+               m_partners.begin() + static_cast<std::ptrdiff_t>(m_partner_offsets[body + 1]));
+}
+
+void SweepAndPrune::query_dynamic(const Physics::Aabb &bounds, const CCollisionFilter &filter, EntityVec &out) const
+{
+    for (const auto &endpoint : m_endpoints)
+    {
+        if (endpoint.value >= bounds.max.x)
+        {
+            break;
+        }
+
+        const auto &body{m_bodies[endpoint.body]};
+        if (!endpoint.is_min || body.removed || !body.dynamic || !Physics::can_collide(filter, body.filter))
+        {
+            continue;
+        }
+
+        if (Physics::overlaps(bounds, body.bounds) && body.entity.is_alive())
+        {
+            out.push_back(body.entity);
+        }
+    }
+}
+
+[[nodiscard]] const SweepAndPrune::Stats &SweepAndPrune::get_stats() const noexcept
+{
+    return m_stats;
+}
+
+uint32_t SweepAndPrune::insert(Entity entity, const Physics::Aabb &bounds, const CCollisionFilter &filter, bool dynamic)
+{
+    if (entity.id() >= m_body_of_entity.size())
+    {
+        m_body_of_entity.resize(entity.id() + 1, no_body);
+    }
+
+    /* The slot may hold an older entity with the same id, it is replaced */
+    auto &index{m_body_of_entity[entity.id()]};
+    if (index != no_body && m_bodies[index].entity == entity)
+    {
+        return index;
+    }
+
+    if (index != no_body)
+    {
+        m_bodies[index].entity = entity;
+        m_bodies[index].bounds = bounds;
+        m_bodies[index].filter = filter;
+        m_bodies[index].dynamic = dynamic;
+        return index;
+    }
+
+    if (m_free_bodies.empty())
+    {
+        index = static_cast<uint32_t>(m_bodies.size());
+        m_bodies.emplace_back();
+    }
+    else
+    {
+        index = m_free_bodies.back();
+        m_free_bodies.pop_back();
+    }
+
+    m_bodies[index] = Body{entity, bounds, filter, dynamic, false, false};
+
+    /* New endpoints are appended, the next sort moves them to their place */
+    m_endpoints.push_back(Endpoint{bounds.min.x, index, true});
+    m_endpoints.push_back(Endpoint{bounds.max.x, index, false});
+    return index;
+}
+
+[[nodiscard]] bool SweepAndPrune::less(const Endpoint &a, const Endpoint &b) noexcept
+{
+    return a.value < b.value || (a.value == b.value && !a.is_min && b.is_min);
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include "physics.hpp"
+
+/**
+ * @brief Incremental sort and sweep broadphase along the x axis.
+ *
+ * Each body adds two endpoints (min x, max x) to a list kept sorted between frames.
+ * Bodies move little from one frame to the next, so the list is almost sorted and an insertion sort
+ * restores the order in close to linear time. A sweep over the endpoints then finds the bodies
+ * whose x intervals overlap, their y intervals are tested to confirm the pair.
+ * The pairs are then bucketed per body, so the partners of a body are found without scanning every pair.
+ *
+ * Bodies are either dynamic (player, bullets...) or static (level colliders that are not in the TileGrid).
+ * Only dynamic-dynamic and dynamic-static pairs are reported, and only if the collision filters of
+ * the two bodies accept each other: this is checked before the y intervals are tested.
+ *
+ * Usage:
+ *
+ * - insert_static(entity, bounds, filter): Add a collider that never moves
+ *
+ * - update_dynamic(entity, bounds, filter): Add or move a moving collider, to call each frame for every dynamic body
+ *
+ * - update(): Remove the bodies that were not updated or are dead, sort the endpoints and find the pairs
+ *
+ * - get_pairs() / get_partners(entity, out): Read the overlapping pairs of the last update
+ *
+ * - query_dynamic(bounds, filter, out): Find the dynamic bodies overlapping any bounds, for scene queries
+ *
+ * - get_stats(): Counters of the last update, to see how much the sweep prunes
+ */
+class SweepAndPrune
+{
+public:
+    /**
+     * @brief Two bodies whose bounds overlap, a has the smaller entity id
+     */
+    struct Pair
+    {
+        Entity a{};
+        Entity b{};
+    };
+
+    /**
+     * @brief Counters of the last update
+     */
+    struct Stats
+    {
+        size_t bodies{};
+        size_t dynamic_bodies{};
+        size_t swaps{};    // Endpoint swaps done by the insertion sort
+        size_t filtered{}; // Pairs whose x intervals overlap, rejected by their collision filters
+        size_t tests{};    // Pairs whose x intervals overlap, tested on y
+        size_t pairs{};    // Pairs that overlap on both axes
+    };
+
+    /**
+     * @brief Default constructor
+     */
+    explicit SweepAndPrune() noexcept = default;
+
+    /**
+     * @brief Add a body that never moves, it stays until its entity is dead
+     *
+     * @param entity Entity
+     * @param bounds World bounds of its collider
+     * @param filter Collision filter of the entity
+     */
+    void insert_static(Entity entity, const Physics::Aabb &bounds, const CCollisionFilter &filter);
+
+    /**
+     * @brief Add a dynamic body, or move it if it already exists
+     *
+     * @param entity Entity
+     * @param bounds World bounds of its collider
+     * @param filter Collision filter of the entity
+     */
+    void update_dynamic(Entity entity, const Physics::Aabb &bounds, const CCollisionFilter &filter);
+
+    /**
+     * @brief Remove stale bodies, sort the endpoints and find the overlapping pairs
+     */
+    void update();
+
+    /**
+     * @brief Remove every body
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Return the overlapping pairs found by the last update
+     */
+    [[nodiscard]]
+    const std::vector<Pair> &get_pairs() const noexcept;
+
+    /**
+     * @brief Append the entities paired with the given entity by the last update, in O(partners)
+     *
+     * @param entity Entity
+     * @param out Partners
+     */
+    void get_partners(const Entity &entity, EntityVec &out) const;
+
+    /**
+     * @brief Append the alive dynamic bodies overlapping the bounds and accepted by the filter, static ones are in the StaticBvh
+     *
+     * The endpoints are walked in the order of the last update, and the walk stops at the first one past the bounds.
+     *
+     * @param bounds World bounds
+     * @param filter Collision filter of the query
+     * @param out Entities
+     */
+    void query_dynamic(const Physics::Aabb &bounds, const CCollisionFilter &filter, EntityVec &out) const;
+
+    /**
+     * @brief Return the counters of the last update
+     */
+    [[nodiscard]]
+    const Stats &get_stats() const noexcept;
+
+private:
+    static constexpr uint32_t no_body{std::numeric_limits<uint32_t>::max()};
+
+    /**
+     * @brief Collider tracked by the sweep
+     */
+    struct Body
+    {
+        Entity entity{};
+        Physics::Aabb bounds{};
+        CCollisionFilter filter{};
+        bool dynamic{false};
+        bool updated{false}; // Dynamic body updated since the last update()
+        bool removed{true};
+    };
+
+    /**
+     * @brief Start or end of a body on the x axis
+     */
+    struct Endpoint
+    {
+        float value{};
+        uint32_t body{};
+        bool is_min{};
+    };
+
+    /**
+     * @brief Add a body and its endpoints, or return the existing body of the entity
+     */
+    uint32_t insert(Entity entity, const Physics::Aabb &bounds, const CCollisionFilter &filter, bool dynamic);
+
+    /**
+     * @brief Sort order of endpoints, an end comes before a start of the same value so touching bodies are not paired
+     */
+    [[nodiscard]]
+    static bool less(const Endpoint &a, const Endpoint &b) noexcept;
+
+private:
+    std::vector<Body> m_bodies{};
+    std::vector<uint32_t> m_free_bodies{};
+    std::vector<uint32_t> m_body_of_entity{}; // Indexed by entity id
+    std::vector<Endpoint> m_endpoints{};      // Sorted by less() after each update
+    std::vector<uint32_t> m_active{};         // Bodies open during the sweep, then next partner slot of each body
+    std::vector<Pair> m_pairs{};
+    std::vector<uint32_t> m_partner_offsets{}; // Partners of body i are m_partners[m_partner_offsets[i], m_partner_offsets[i + 1])
+    EntityVec m_partners{};
+    Stats m_stats{};
+};
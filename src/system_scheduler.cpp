@@ -0,0 +1,47 @@
+#include "system_scheduler.hpp"
+
+void SystemScheduler::add_system(const std::string &name, ComponentMask reads, ComponentMask writes, std::function<void()> function)
+{
+    System system{name, reads, writes, std::move(function), {}};
+    for (size_t i = 0; i < m_systems.size(); ++i)
+    {
+        if (conflict(system, m_systems[i]))
+        {
+            system.dependencies.push_back(i);
+        }
+    }
+    m_systems.push_back(std::move(system));
+}
+
+void SystemScheduler::run(JobSystem &jobs)
+{
+    /* Systems are scheduled in registration order, so their dependencies already have a job */
+    m_jobs.clear();
+    std::vector<JobHandle> dependencies{};
+    for (const auto &system : m_systems)
+    {
+        dependencies.clear();
+        for (const auto index : system.dependencies)
+        {
+            dependencies.push_back(m_jobs[index]);
+        }
+        m_jobs.push_back(jobs.schedule([&system]()
+                                       { system.function(); },
+                                       dependencies));
+    }
+
+    for (const auto &job : m_jobs)
+    {
+        jobs.wait(job);
+    }
+}
+
+[[nodiscard]] const std::vector<SystemScheduler::System> &SystemScheduler::get_systems() const noexcept
+{
+    return m_systems;
+}
+
+[[nodiscard]] bool SystemScheduler::conflict(const System &a, const System &b) noexcept
+{
+    return (a.writes & (b.reads | b.writes)) != 0 || (b.writes & a.reads) != 0;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include "component_pool.hpp"
+#include "job_system.hpp"
+
+/**
+ * @brief Runs the systems of a scene, in parallel when they do not touch the same components.
+ *
+ * Each system declares the components it reads and the components it writes.
+ * Two systems conflict if one of them writes a component the other one reads or writes.
+ *
+ * Each system runs as a job of the JobSystem, depending on the previously registered systems it conflicts with.
+ * Conflicting systems always run in their registration order, the others run concurrently.
+ *
+ * Usage:
+ *
+ * - add_system(name, reads, writes, function): Register a system, masks are built with component_mask<Ts...>()
+ *
+ * - run(jobs): Run every system and wait for them
+ *
+ * - get_systems(): Access the systems and their dependencies, for display
+ *
+ * @note Systems must not make structural changes while running, they record them in a CommandBuffer instead
+ * @note State that is not a component (counters, flags of the scene) must be protected by the declared components,
+ * i.e. only systems that already conflict may share it
+ * @note Systems must only use EntityManager queries built before run(), building one is not thread safe
+ */
+class SystemScheduler
+{
+public:
+    /**
+     * @brief Registered system
+     */
+    struct System
+    {
+        std::string name{};
+        ComponentMask reads{};
+        ComponentMask writes{};
+        std::function<void()> function{};
+        std::vector<size_t> dependencies{}; // Previous systems it conflicts with
+    };
+
+    /**
+     * @brief Default constructor
+     */
+    explicit SystemScheduler() noexcept = default;
+
+    /**
+     * @brief Register a system, it runs after the systems it conflicts with
+     *
+     * @param name System's name
+     * @param reads Components read by the system
+     * @param writes Components written by the system
+     * @param function Function running the system
+     */
+    void add_system(const std::string &name, ComponentMask reads, ComponentMask writes, std::function<void()> function);
+
+    /**
+     * @brief Run every system as a job, wait until they are all finished
+     *
+     * @param jobs Job system
+     */
+    void run(JobSystem &jobs);
+
+    /**
+     * @brief Return the registered systems
+     */
+    [[nodiscard]]
+    const std::vector<System> &get_systems() const noexcept;
+
+private:
+    /**
+     * @brief Check if two systems cannot run at the same time
+     */
+    [[nodiscard]]
+    static bool conflict(const System &a, const System &b) noexcept;
+
+private:
+    std::vector<System> m_systems{};
+    std::vector<JobHandle> m_jobs{};
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief Tag of an entity, used to group entities of the same kind.
+ *
+ * Tags are small integers known at compile time, so the EntityManager can store
+ * one bucket of entities per tag in a flat array instead of hashing strings.
+ *
+ * @note To add a tag, insert it before Count and give it a name in tag_names
+ */
+enum class Tag : uint8_t
+{
+    Default,
+    Tile,
+    Dec,
+    Spike,
+    Player,
+    Bullet,
+    Coin,
+    Sound,
+    Count
+};
+
+/**
+ * @brief Number of tags
+ */
+inline constexpr size_t tag_count{static_cast<size_t>(Tag::Count)};
+
+/**
+ * @brief Name of each tag, only used for display (ImGui, logs)
+ */
+inline constexpr std::array<const char *, tag_count> tag_names{
+    "default",
+    "tile",
+    "dec",
+    "spike",
+    "player",
+    "bullet",
+    "coin",
+    "sound"};
+
+/**
+ * @brief Return the name of the given tag
+ *
+ * @param tag Tag
+ */
+[[nodiscard]]
+constexpr const char *tag_name(Tag tag) noexcept
+{
+    return tag_names[static_cast<size_t>(tag)];
+}
@@ -0,0 +1,368 @@
+#include "tile_grid.hpp"
+
+TileGrid::TileGrid(const sf::Vector2f &cell_size) noexcept : m_cell_size(cell_size)
+{
+}
+
+[[nodiscard]] std::vector<TileGrid::Tile> TileGrid::build(float ground_y, std::span<const Tile> tiles)
+{
+    m_ground_y = ground_y;
+    m_cells.clear();
+    m_merged.clear();
+    m_free_merged.clear();
+    m_merged_tiles = 0;
+    m_width = 0;
+    m_height = 0;
+
+    /* Bounds are shrunk a little so that tiles touching the border of their cell only fill this cell */
+    static constexpr float epsilon{0.01f};
+    const sf::Vector2f shrink{epsilon, epsilon};
+
+    std::vector<Tile> fitting{};
+    std::vector<Tile> rejected{};
+    for (const auto &tile : tiles)
+    {
+        const Coord min{to_cell(tile.bounds.min + shrink)};
+        const Coord max{to_cell(tile.bounds.max - shrink)};
+        if (min.x == max.x && min.y == max.y)
+        {
+            fitting.push_back(tile);
+        }
+        else
+        {
+            rejected.push_back(tile);
+        }
+    }
+
+    if (fitting.empty())
+    {
+        return rejected;
+    }
+
+    /* Size the grid to the extent of the fitting tiles */
+    Coord min{to_cell(fitting.front().bounds.min + shrink)};
+    Coord max{min};
+    for (const auto &tile : fitting)
+    {
+        const Coord cell{to_cell(tile.bounds.min + shrink)};
+        min = Coord{std::min(min.x, cell.x), std::min(min.y, cell.y)};
+        max = Coord{std::max(max.x, cell.x), std::max(max.y, cell.y)};
+    }
+
+    m_origin = min;
+    m_width = max.x - min.x + 1;
+    m_height = max.y - min.y + 1;
+    m_cells.assign(static_cast<size_t>(m_width) * static_cast<size_t>(m_height), Cell{});
+
+    for (const auto &tile : fitting)
+    {
+        const Coord cell{to_cell(tile.bounds.min + shrink)};
+        auto &target{at(cell)};
+
+        /* Two tiles at the same place, the second one cannot be stored */
+        if (target.type != TileType::Empty)
+        {
+            rejected.push_back(tile);
+            continue;
+        }
+        target = Cell{tile.type, tile.entity, tile.filter, no_collider};
+    }
+    return rejected;
+}
+
+size_t TileGrid::merge()
+{
+    merge_region(m_origin, Coord{m_origin.x + m_width - 1, m_origin.y + m_height - 1});
+    return get_merged_count();
+}
+
+void TileGrid::query(const Physics::Aabb &bounds, const CCollisionFilter &filter, EntityVec &out) const
+{
+    /* Pixel y goes down, rows go up: the bottom of the bounds is the lowest row */
+    const Coord low{to_cell(sf::Vector2f{bounds.min.x, bounds.max.y})};
+    const Coord high{to_cell(sf::Vector2f{bounds.max.x, bounds.min.y})};
+
+    for (int32_t y = low.y - 1; y <= high.y + 1; ++y)
+    {
+        for (int32_t x = low.x - 1; x <= high.x + 1; ++x)
+        {
+            const auto &cell{get_cell(x, y)};
+            if (cell.type != TileType::Empty && cell.collider == no_collider && Physics::can_collide(filter, cell.filter) &&
+                cell.entity.is_alive())
+            {
+                out.push_back(cell.entity);
+            }
+        }
+    }
+}
+
+void TileGrid::query_merged(const Physics::Aabb &bounds, const CCollisionFilter &filter, std::vector<uint32_t> &out) const
+{
+    out.clear();
+    const Coord low{to_cell(sf::Vector2f{bounds.min.x, bounds.max.y})};
+    const Coord high{to_cell(sf::Vector2f{bounds.max.x, bounds.min.y})};
+
+    for (int32_t y = low.y - 1; y <= high.y + 1; ++y)
+    {
+        for (int32_t x = low.x - 1; x <= high.x + 1; ++x)
+        {
+            const auto &cell{get_cell(x, y)};
+            if (cell.collider != no_collider && Physics::can_collide(filter, cell.filter))
+            {
+                out.push_back(cell.collider);
+            }
+        }
+    }
+
+    /* A rectangle covers several cells */
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+void TileGrid::overlap(const Physics::Aabb &bounds, const CCollisionFilter &filter, EntityVec &out) const
+{
+    const Coord low{to_cell(sf::Vector2f{bounds.min.x, bounds.max.y})};
+    const Coord high{to_cell(sf::Vector2f{bounds.max.x, bounds.min.y})};
+
+    for (int32_t y = low.y; y <= high.y; ++y)
+    {
+        for (int32_t x = low.x; x <= high.x; ++x)
+        {
+            const auto &cell{get_cell(x, y)};
+            if (cell.type != TileType::Empty && Physics::can_collide(filter, cell.filter) && cell.entity.is_alive())
+            {
+                out.push_back(cell.entity);
+            }
+        }
+    }
+}
+
+[[nodiscard]] bool TileGrid::raycast(const sf::Vector2f &origin, const sf::Vector2f &direction, float max_distance,
+                                     const CCollisionFilter &filter, Physics::RayHit &hit) const
+{
+    if (m_cells.empty())
+    {
+        return false;
+    }
+
+    /* Walk in cell units, rows go up when the pixel y goes down */
+    const sf::Vector2f start{origin.x / m_cell_size.x, (m_ground_y - origin.y) / m_cell_size.y};
+    const sf::Vector2f step_size{direction.x / m_cell_size.x, -direction.y / m_cell_size.y};
+
+    Coord cell{to_cell(origin)};
+    const int32_t step_x{step_size.x > 0.0f ? 1 : -1};
+    const int32_t step_y{step_size.y > 0.0f ? 1 : -1};
+
+    /* Distance along the ray to the next column and row borders, and between two borders */
+    static constexpr float infinity{std::numeric_limits<float>::infinity()};
+    const float delta_x{step_size.x != 0.0f ? std::abs(1.0f / step_size.x) : infinity};
+    const float delta_y{step_size.y != 0.0f ? std::abs(1.0f / step_size.y) : infinity};
+    float next_x{step_size.x != 0.0f ? (static_cast<float>(cell.x + (step_x > 0 ? 1 : 0)) - start.x) / step_size.x : infinity};
+    float next_y{step_size.y != 0.0f ? (static_cast<float>(cell.y + (step_y > 0 ? 1 : 0)) - start.y) / step_size.y : infinity};
+
+    float distance{0.0f};
+    while (distance <= max_distance)
+    {
+        const auto &tile{get_cell(cell.x, cell.y)};
+        if (tile.type != TileType::Empty && Physics::can_collide(filter, tile.filter) && tile.entity.is_alive())
+        {
+            float hit_distance{};
+            sf::Vector2f normal{};
+            if (Physics::raycast_bounds(origin, direction, max_distance, Physics::get_bounds(tile.entity), hit_distance, normal))
+            {
+                hit = Physics::RayHit{tile.entity, origin + direction * hit_distance, normal, hit_distance};
+                return true;
+            }
+        }
+
+        /* Stop once the ray is out of the grid and going away from it */
+        const bool away_x{(cell.x < m_origin.x && step_size.x <= 0.0f) || (cell.x >= m_origin.x + m_width && step_size.x >= 0.0f)};
+        const bool away_y{(cell.y < m_origin.y && step_size.y <= 0.0f) || (cell.y >= m_origin.y + m_height && step_size.y >= 0.0f)};
+        if (away_x || away_y)
+        {
+            return false;
+        }
+
+        if (next_x < next_y)
+        {
+            distance = next_x;
+            next_x += delta_x;
+            cell.x += step_x;
+        }
+        else
+        {
+            distance = next_y;
+            next_y += delta_y;
+            cell.y += step_y;
+        }
+    }
+    return false;
+}
+
+[[nodiscard]] Physics::Aabb TileGrid::get_merged_bounds(uint32_t index) const noexcept
+{
+    const auto &rect{m_merged[index]};
+    return Physics::Aabb{sf::Vector2f{rect.min.x * m_cell_size.x, m_ground_y - (rect.max.y + 1) * m_cell_size.y},
+                         sf::Vector2f{(rect.max.x + 1) * m_cell_size.x, m_ground_y - rect.min.y * m_cell_size.y}};
+}
+
+[[nodiscard]] size_t TileGrid::get_merged_count() const noexcept
+{
+    return m_merged.size() - m_free_merged.size();
+}
+
+[[nodiscard]] size_t TileGrid::get_merged_tile_count() const noexcept
+{
+    return m_merged_tiles;
+}
+
+[[nodiscard]] const TileGrid::Cell &TileGrid::get_tile(const sf::Vector2f &point) const noexcept
+{
+    const Coord cell{to_cell(point)};
+    return get_cell(cell.x, cell.y);
+}
+
+[[nodiscard]] const TileGrid::Cell &TileGrid::get_cell(int32_t x, int32_t y) const noexcept
+{
+    static const Cell empty{};
+    if (!contains(Coord{x, y}))
+    {
+        return empty;
+    }
+    return m_cells[static_cast<size_t>(y - m_origin.y) * m_width + (x - m_origin.x)];
+}
+
+[[nodiscard]] TileGrid::Cell &TileGrid::at(Coord coord) noexcept
+{
+    return m_cells[static_cast<size_t>(coord.y - m_origin.y) * m_width + (coord.x - m_origin.x)];
+}
+
+void TileGrid::remove(const Entity &entity, const Physics::Aabb &bounds) noexcept
+{
+    const Coord cell{to_cell(0.5f * (bounds.min + bounds.max))};
+    if (!contains(cell))
+    {
+        return;
+    }
+
+    auto &target{at(cell)};
+    if (target.entity != entity)
+    {
+        return;
+    }
+
+    const uint32_t collider{target.collider};
+    target = Cell{};
+    if (collider == no_collider)
+    {
+        return;
+    }
+
+    /* Split the rectangle: its remaining tiles are merged again, inside its area only */
+    auto &rect{m_merged[collider]};
+    for (int32_t y = rect.min.y; y <= rect.max.y; ++y)
+    {
+        for (int32_t x = rect.min.x; x <= rect.max.x; ++x)
+        {
+            auto &merged{at(Coord{x, y})};
+            if (merged.collider == collider)
+            {
+                merged.collider = no_collider;
+                m_merged_tiles--;
+            }
+        }
+    }
+    m_merged_tiles--; // The removed tile
+
+    rect.alive = false;
+    m_free_merged.push_back(collider);
+    merge_region(rect.min, rect.max);
+}
+
+[[nodiscard]] int32_t TileGrid::get_width() const noexcept
+{
+    return m_width;
+}
+
+[[nodiscard]] int32_t TileGrid::get_height() const noexcept
+{
+    return m_height;
+}
+
+[[nodiscard]] TileGrid::Coord TileGrid::to_cell(const sf::Vector2f &point) const noexcept
+{
+    return Coord{static_cast<int32_t>(std::floor(point.x / m_cell_size.x)),
+                 static_cast<int32_t>(std::floor((m_ground_y - point.y) / m_cell_size.y))};
+}
+
+[[nodiscard]] bool TileGrid::contains(Coord coord) const noexcept
+{
+    return coord.x >= m_origin.x && coord.x < m_origin.x + m_width &&
+           coord.y >= m_origin.y && coord.y < m_origin.y + m_height;
+}
+
+[[nodiscard]] bool TileGrid::is_mergeable(const Cell &cell, const CCollisionFilter &filter) noexcept
+{
+    return (cell.type == TileType::Solid || cell.type == TileType::Brick) && cell.collider == no_collider &&
+           cell.filter.layer == filter.layer && cell.filter.mask == filter.mask && cell.entity.is_alive();
+}
+
+void TileGrid::merge_region(Coord min, Coord max)
+{
+    for (int32_t y = min.y; y <= max.y; ++y)
+    {
+        for (int32_t x = min.x; x <= max.x; ++x)
+        {
+            /* The first cell gives the filter of the rectangle */
+            const CCollisionFilter filter{at(Coord{x, y}).filter};
+            if (!is_mergeable(at(Coord{x, y}), filter))
+            {
+                continue;
+            }
+
+            /* Grow to the right as far as possible, then upwards while the whole row can be merged */
+            int32_t right{x};
+            while (right + 1 <= max.x && is_mergeable(at(Coord{right + 1, y}), filter))
+            {
+                right++;
+            }
+
+            int32_t top{y};
+            while (top + 1 <= max.y)
+            {
+                bool full_row{true};
+                for (int32_t i = x; i <= right && full_row; ++i)
+                {
+                    full_row = is_mergeable(at(Coord{i, top + 1}), filter);
+                }
+                if (!full_row)
+                {
+                    break;
+                }
+                top++;
+            }
+
+            uint32_t index{};
+            if (m_free_merged.empty())
+            {
+                index = static_cast<uint32_t>(m_merged.size());
+                m_merged.emplace_back();
+            }
+            else
+            {
+                index = m_free_merged.back();
+                m_free_merged.pop_back();
+            }
+            m_merged[index] = Rect{Coord{x, y}, Coord{right, top}, true};
+
+            for (int32_t j = y; j <= top; ++j)
+            {
+                for (int32_t i = x; i <= right; ++i)
+                {
+                    at(Coord{i, j}).collider = index;
+                    m_merged_tiles++;
+                }
+            }
+        }
+    }
+}
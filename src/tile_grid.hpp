@@ -0,0 +1,294 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include "physics.hpp"
+
+/**
+ * @brief Kind of static collider stored in a TileGrid cell
+ */
+enum class TileType : uint8_t
+{
+    Empty,
+    Solid,
+    Brick,
+    Question,
+    Flagpole,
+    Spike
+};
+
+/**
+ * @brief Dense occupancy grid of the static colliders of a level.
+ *
+ * Levels place tiles on integer grid coordinates, so most tiles fill exactly one cell.
+ * The grid stores, for each cell, the type of its tile, its collision filter and the entity holding the collider.
+ * Cell coordinates are the level coordinates: x to the right, y upwards from the ground line.
+ *
+ * Adjacent solid tiles and bricks with the same collision filter are merged into maximal rectangles, a floor of 40 tiles is one collider.
+ * Merged colliders only live in the grid, the tile entities are still rendered one by one.
+ * When a brick is destroyed, the rectangle holding it is split into the rectangles covering the remaining tiles.
+ *
+ * Usage:
+ *
+ * - build(ground_y, tiles): Fill the grid once the level is loaded
+ *
+ * - merge(): Merge the solid tiles and bricks into rectangles
+ *
+ * - query(bounds, filter, out): Append the tiles of the cells overlapped by the bounds and of their neighbours,
+ *   if not merged and accepted by the filter
+ *
+ * - query_merged(bounds, filter, out): Collect the merged rectangles of the same cells
+ *
+ * - overlap(bounds, filter, out): Append the tiles of the cells overlapped by the bounds, merged or not
+ *
+ * - raycast(origin, direction, max_distance, filter, hit): Walk the cells along a ray and stop at the first tile hit
+ *
+ * - get_tile(point): Access the cell holding a point, to find the tile hit inside a merged rectangle
+ *
+ * - get_cell(x, y): Access a cell, cells outside of the grid are empty
+ *
+ * - remove(entity, bounds): Clear the cell of a destroyed tile, and split its merged rectangle
+ *
+ * @note Colliders that do not fill exactly one cell are not stored, build() returns them
+ */
+class TileGrid
+{
+public:
+    static constexpr uint32_t no_collider{std::numeric_limits<uint32_t>::max()};
+
+    /**
+     * @brief Static collider to store in the grid
+     */
+    struct Tile
+    {
+        Entity entity{};
+        TileType type{TileType::Empty};
+        Physics::Aabb bounds{};
+        CCollisionFilter filter{};
+    };
+
+    /**
+     * @brief Content of a cell
+     */
+    struct Cell
+    {
+        TileType type{TileType::Empty};
+        Entity entity{};
+        CCollisionFilter filter{};
+        uint32_t collider{no_collider}; // Merged rectangle holding the cell
+    };
+
+    /**
+     * @brief Create an empty grid
+     *
+     * @param cell_size Size of a cell, in pixels
+     */
+    explicit TileGrid(const sf::Vector2f &cell_size) noexcept;
+
+    /**
+     * @brief Replace the content of the grid with the given tiles
+     *
+     * @param ground_y Pixel y coordinate of the bottom of the row 0
+     * @param tiles Static colliders of the level
+     *
+     * @return The tiles that do not fill exactly one cell
+     */
+    [[nodiscard]]
+    std::vector<Tile> build(float ground_y, std::span<const Tile> tiles);
+
+    /**
+     * @brief Merge adjacent solid tiles and bricks with the same filter into maximal rectangles, greedily row by row
+     *
+     * @return Number of merged rectangles
+     */
+    size_t merge();
+
+    /**
+     * @brief Append the alive entities of the cells overlapped by the bounds and of their neighbouring cells,
+     * cells of merged rectangles and tiles rejected by the filter are skipped
+     *
+     * @param bounds World bounds
+     * @param filter Collision filter of the entity looking for tiles
+     * @param out Entities, each one is appended once
+     */
+    void query(const Physics::Aabb &bounds, const CCollisionFilter &filter, EntityVec &out) const;
+
+    /**
+     * @brief Collect the merged rectangles of the cells overlapped by the bounds and of their neighbouring cells
+     *
+     * @param bounds World bounds
+     * @param filter Collision filter of the entity looking for tiles, rectangles it rejects are skipped
+     * @param out Indices of the rectangles, cleared first, without duplicates
+     */
+    void query_merged(const Physics::Aabb &bounds, const CCollisionFilter &filter, std::vector<uint32_t> &out) const;
+
+    /**
+     * @brief Append the alive entities of the cells overlapped by the bounds, merged or not, accepted by the filter
+     *
+     * @param bounds World bounds
+     * @param filter Collision filter of the query
+     * @param out Entities, each one is appended once
+     */
+    void overlap(const Physics::Aabb &bounds, const CCollisionFilter &filter, EntityVec &out) const;
+
+    /**
+     * @brief Find the first tile hit by a ray, visiting only the cells crossed by the ray
+     *
+     * Cells are walked in order along the ray (Amanatides-Woo traversal), the bounds of the collider of each tile are tested.
+     * A tile fills a single cell, so the first tile hit is the closest one.
+     *
+     * @param origin Start of the ray
+     * @param direction Unit direction of the ray
+     * @param max_distance Length of the ray
+     * @param filter Collision filter of the query
+     * @param hit Closest tile hit
+     *
+     * @return True if a tile is hit
+     */
+    [[nodiscard]]
+    bool raycast(const sf::Vector2f &origin, const sf::Vector2f &direction, float max_distance, const CCollisionFilter &filter,
+                 Physics::RayHit &hit) const;
+
+    /**
+     * @brief Return the world bounds of a merged rectangle
+     *
+     * @param index Index given by query_merged
+     */
+    [[nodiscard]]
+    Physics::Aabb get_merged_bounds(uint32_t index) const noexcept;
+
+    /**
+     * @brief Return the number of merged rectangles
+     */
+    [[nodiscard]]
+    size_t get_merged_count() const noexcept;
+
+    /**
+     * @brief Return the number of tiles in merged rectangles
+     */
+    [[nodiscard]]
+    size_t get_merged_tile_count() const noexcept;
+
+    /**
+     * @brief Call function(bounds) for each merged rectangle, for debug drawing
+     */
+    template <typename F>
+    void for_each_merged(F &&function) const;
+
+    /**
+     * @brief Return the cell holding the given world point
+     *
+     * @param point World position
+     */
+    [[nodiscard]]
+    const Cell &get_tile(const sf::Vector2f &point) const noexcept;
+
+    /**
+     * @brief Return the cell at the given level coordinates, an empty cell if it is outside of the grid
+     *
+     * @param x Column
+     * @param y Row, from the ground upwards
+     */
+    [[nodiscard]]
+    const Cell &get_cell(int32_t x, int32_t y) const noexcept;
+
+    /**
+     * @brief Clear the cell holding the entity, nothing happens if the entity is not in the grid
+     *
+     * @param entity Tile's entity
+     * @param bounds World bounds of its collider
+     */
+    void remove(const Entity &entity, const Physics::Aabb &bounds) noexcept;
+
+    /**
+     * @brief Return the number of columns
+     */
+    [[nodiscard]]
+    int32_t get_width() const noexcept;
+
+    /**
+     * @brief Return the number of rows
+     */
+    [[nodiscard]]
+    int32_t get_height() const noexcept;
+
+private:
+    /**
+     * @brief Level coordinates of a cell
+     */
+    struct Coord
+    {
+        int32_t x{};
+        int32_t y{};
+    };
+
+    /**
+     * @brief Return the coordinates of the cell holding the point
+     */
+    [[nodiscard]]
+    Coord to_cell(const sf::Vector2f &point) const noexcept;
+
+    /**
+     * @brief Merged rectangle, in cell coordinates, bounds included
+     */
+    struct Rect
+    {
+        Coord min{};
+        Coord max{};
+        bool alive{false};
+    };
+
+    /**
+     * @brief Return true if the coordinates are inside the grid
+     */
+    [[nodiscard]]
+    bool contains(Coord coord) const noexcept;
+
+    /**
+     * @brief Return the cell at the given coordinates, which must be inside the grid
+     */
+    [[nodiscard]]
+    Cell &at(Coord coord) noexcept;
+
+    /**
+     * @brief Return true if the cell can be part of a merged rectangle with the given filter
+     */
+    [[nodiscard]]
+    static bool is_mergeable(const Cell &cell, const CCollisionFilter &filter) noexcept;
+
+    /**
+     * @brief Merge the mergeable cells of a region that are not merged yet
+     *
+     * @param min First cell of the region
+     * @param max Last cell of the region, included
+     */
+    void merge_region(Coord min, Coord max);
+
+private:
+    sf::Vector2f m_cell_size{};
+    float m_ground_y{};
+    Coord m_origin{}; // Coordinates of the first cell of m_cells
+    int32_t m_width{};
+    int32_t m_height{};
+    std::vector<Cell> m_cells{}; // Row major, m_width * m_height
+    std::vector<Rect> m_merged{};
+    std::vector<uint32_t> m_free_merged{};
+    size_t m_merged_tiles{};
+};
+
+/* TEMPLATE FUNCTIONS HERE */
+
+template <typename F>
+void TileGrid::for_each_merged(F &&function) const
+{
+    for (uint32_t i = 0; i < m_merged.size(); ++i)
+    {
+        if (m_merged[i].alive)
+        {
+            function(get_merged_bounds(i));
+        }
+    }
+}